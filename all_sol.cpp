@@ -10,12 +10,41 @@
 #include <thread>
 #include <mutex>
 #include <queue>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cerrno>
+#include <atomic>
+#include <functional>
+#include <cmath>
+#include <random>
+#include <set>
+#include <deque>
+#include <condition_variable>
+#include <memory>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <sys/mman.h>
+#include <sched.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
 
 using namespace std;
 using namespace chrono;
 
 mutex mtx;
 
+// Модули для задач 5-8 (как в all_sol_mod.cpp), используются с флагом --modular.
+const long long A_MAX_1 = static_cast<long long>(pow(2, 24/0.8));
+const long long A_MAX_2 = static_cast<long long>(pow(2, 24));
+const long long A_MAX_3 = static_cast<long long>(pow(2, 24/1.2));
+const long long A_MAX_4 = static_cast<long long>(pow(2, 24/1.4));
+const vector<long long> A_MAX_VALUES = {A_MAX_1, A_MAX_2, A_MAX_3, A_MAX_4};
+
 vector<string> split(const string& s, char delimiter) {
     vector<string> tokens;
     string token;
@@ -47,8 +76,56 @@ vector<vector<long long>> load_problems(const string& filename) {
     return problems;
 }
 
+// Полный перебор для фиксированного n: веса лежат в std::array, подмножества размера r
+// перебираются приёмом Госпера по маске, а сумма считается развёрнутым циклом без ветвлений.
+template <int N>
+tuple<double, double, int> solve_knapsack_bruteforce_fixed(const vector<long long>& items, long long target_weight) {
+    array<long long, N> weights;
+    copy(items.begin(), items.begin() + N, weights.begin());
+
+    double first_solution_time = 0.0;
+    int solutions_count = 0;
+
+    auto start_time = high_resolution_clock::now();
+
+    for (int r = 1; r <= N; ++r) {
+        uint64_t mask = r == 64 ? ~uint64_t(0) : (uint64_t(1) << r) - 1;
+        while (true) {
+            long long current_sum = 0;
+#pragma GCC unroll 64
+            for (int i = 0; i < N; ++i) {
+                current_sum += static_cast<long long>((mask >> i) & 1) * weights[i];
+            }
+            if (current_sum == target_weight) {
+                solutions_count++;
+                if (first_solution_time == 0.0) {
+                    first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+                }
+            }
+
+            uint64_t lowest = mask & (~mask + 1);
+            uint64_t ripple = mask + lowest;
+            if (ripple == 0) break;
+            mask = (((ripple ^ mask) >> 2) / lowest) | ripple;
+            if constexpr (N < 64) {
+                if (mask >> N) break;
+            }
+        }
+    }
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, solutions_count);
+}
+
 tuple<double, double, int> solve_knapsack_bruteforce(const vector<long long>& items, long long target_weight) {
     int n = items.size() - 1;
+    switch (n) {
+        case 16: return solve_knapsack_bruteforce_fixed<16>(items, target_weight);
+        case 24: return solve_knapsack_bruteforce_fixed<24>(items, target_weight);
+        case 32: return solve_knapsack_bruteforce_fixed<32>(items, target_weight);
+        case 48: return solve_knapsack_bruteforce_fixed<48>(items, target_weight);
+        case 64: return solve_knapsack_bruteforce_fixed<64>(items, target_weight);
+    }
     vector<long long> weights(items.begin(), items.end() - 1);
 
     double first_solution_time = 0.0;
@@ -79,78 +156,1893 @@ tuple<double, double, int> solve_knapsack_bruteforce(const vector<long long>& it
     return make_tuple(first_solution_time, all_solutions_time, solutions_count);
 }
 
-struct Result {
-    int problem_number;
-    double first_solution_time;
-    double all_solutions_time;
-    int solutions_count;
+// Число младших весов, суммы подмножеств которых лежат в таблице (2^12 * 8 байт = 32 КБ, помещается в L1).
+const int BLOCK_BITS = 12;
+
+// Считает, сколько элементов таблицы равны need, без ветвлений.
+long long count_block_matches(const long long* sums, size_t size, long long need) {
+    long long matches = 0;
+    size_t j = 0;
+#ifdef __AVX2__
+    __m256i needle = _mm256_set1_epi64x(need);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    for (; j + 8 <= size; j += 8) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + j));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sums + j + 4));
+        acc0 = _mm256_sub_epi64(acc0, _mm256_cmpeq_epi64(a, needle));
+        acc1 = _mm256_sub_epi64(acc1, _mm256_cmpeq_epi64(b, needle));
+    }
+    alignas(32) long long lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc0, acc1));
+    matches = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+    for (; j < size; ++j) {
+        matches += (sums[j] == need);
+    }
+    return matches;
+}
+
+// Блочный перебор: суммы всех подмножеств младших BLOCK_BITS весов считаются один раз,
+// старшие веса перебираются в порядке кода Грея, и для каждой их суммы таблица
+// целиком сравнивается с остатком до цели.
+tuple<double, double, int> solve_knapsack_blocked(const vector<long long>& items, long long target_weight) {
+    int n = items.size() - 1;
+    vector<long long> weights(items.begin(), items.end() - 1);
+    int low_bits = min(n, BLOCK_BITS);
+    int high_bits = n - low_bits;
+
+    double first_solution_time = 0.0;
+    long long solutions_count = 0;
+
+    auto start_time = high_resolution_clock::now();
+
+    vector<long long> low_sums(size_t(1) << low_bits, 0);
+    for (int i = 0; i < low_bits; ++i) {
+        size_t half = size_t(1) << i;
+        for (size_t mask = 0; mask < half; ++mask) {
+            low_sums[half + mask] = low_sums[mask] + weights[i];
+        }
+    }
+
+    unsigned long long high_count = 1ULL << high_bits;
+    unsigned long long gray = 0;
+    long long high_sum = 0;
+    for (unsigned long long h = 0; h < high_count; ++h) {
+        if (h > 0) {
+            int bit = __builtin_ctzll(h);
+            gray ^= 1ULL << bit;
+            high_sum += (gray >> bit & 1) ? weights[low_bits + bit] : -weights[low_bits + bit];
+        }
+        solutions_count += count_block_matches(low_sums.data(), low_sums.size(), target_weight - high_sum);
+        if (solutions_count > 0 && first_solution_time == 0.0) {
+            first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+        }
+    }
+    // Пустое подмножество полный перебор не рассматривает.
+    if (target_weight == 0) solutions_count--;
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, static_cast<int>(solutions_count));
+}
+
+// Число потоков, между которыми делится верхняя часть дерева поиска (--engine-threads=N).
+unsigned int engine_threads = 1;
+
+// Модуль, по которому сравниваются суммы в текущей задаче (0 — без модуля).
+// Учитывают его только методы modular и lll. Свой у каждого потока: его задаёт тот,
+// кто запускает поток (worker, knapsack_solve), так что вызовы с разными модулями
+// могут идти параллельно.
+thread_local long long engine_modulus = 0;
+
+struct SearchNode {
+    int depth;
+    long long sum;
 };
 
-void worker(queue<int>& problem_indices, const vector<vector<long long>>& problems, vector<Result>& results) {
-    while (true) {
-        int problem_index;
-        {
+// Ветви и границы по весам, отсортированным по убыванию. Вершина отсекается, если
+// сумма уже больше цели или даже вместе со всеми оставшимися весами её не достигает.
+// Обход в глубину с явным стеком; при engine_threads > 1 вершины на глубине
+// split_depth раздаются потокам. При first_only поиск останавливается на первом решении.
+tuple<double, double, int> branch_and_bound(const vector<long long>& items, long long target_weight, bool first_only) {
+    int n = items.size() - 1;
+    vector<long long> weights(items.begin(), items.end() - 1);
+    sort(weights.begin(), weights.end(), greater<long long>());
+
+    vector<long long> suffix(n + 1, 0);
+    for (int i = n - 1; i >= 0; --i) {
+        suffix[i] = suffix[i + 1] + weights[i];
+    }
+
+    atomic<long long> solutions_count(0);
+    atomic<bool> stop(false);
+    double first_solution_time = 0.0;
+    mutex first_mtx;
+
+    auto start_time = high_resolution_clock::now();
+
+    auto record_solution = [&]() {
+        if (solutions_count.fetch_add(1) == 0) {
+            lock_guard<mutex> lock(first_mtx);
+            first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+        }
+        if (first_only) stop = true;
+    };
+
+    // Возвращает true, если из вершины стоит спускаться дальше.
+    auto expand = [&](const SearchNode& node) {
+        if (node.sum > target_weight || node.sum + suffix[node.depth] < target_weight) return false;
+        if (node.sum == target_weight) {
+            if (node.depth > 0 || target_weight != 0) record_solution();
+            return false;
+        }
+        return node.depth < n;
+    };
+
+    auto search = [&](SearchNode root, vector<SearchNode>& stack) {
+        stack.clear();
+        stack.push_back(root);
+        while (!stack.empty() && !stop) {
+            SearchNode node = stack.back();
+            stack.pop_back();
+            if (!expand(node)) continue;
+            stack.push_back({node.depth + 1, node.sum});
+            stack.push_back({node.depth + 1, node.sum + weights[node.depth]});
+        }
+    };
+
+    if (engine_threads <= 1) {
+        vector<SearchNode> stack;
+        stack.reserve(n + 2);
+        search({0, 0}, stack);
+    } else {
+        int split_depth = 0;
+        while (split_depth < n && (1u << split_depth) < 8 * engine_threads) ++split_depth;
+
+        vector<SearchNode> frontier = {{0, 0}};
+        for (int d = 0; d < split_depth; ++d) {
+            vector<SearchNode> next;
+            for (const SearchNode& node : frontier) {
+                if (!expand(node)) continue;
+                next.push_back({d + 1, node.sum + weights[d]});
+                next.push_back({d + 1, node.sum});
+            }
+            frontier.swap(next);
+        }
+
+        atomic<size_t> next_task(0);
+        vector<thread> threads;
+        for (unsigned int t = 0; t < engine_threads; ++t) {
+            threads.emplace_back([&]() {
+                vector<SearchNode> stack;
+                stack.reserve(n + 2);
+                for (size_t task = next_task++; task < frontier.size() && !stop; task = next_task++) {
+                    search(frontier[task], stack);
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, static_cast<int>(solutions_count.load()));
+}
+
+tuple<double, double, int> solve_knapsack_branch_and_bound(const vector<long long>& items, long long target_weight) {
+    return branch_and_bound(items, target_weight, false);
+}
+
+tuple<double, double, int> solve_knapsack_branch_and_bound_first(const vector<long long>& items, long long target_weight) {
+    return branch_and_bound(items, target_weight, true);
+}
+
+// Способ выделения памяти под большие таблицы сумм (--huge-pages=thp|explicit).
+enum class HugePages { None, Transparent, Explicit };
+HugePages huge_pages = HugePages::None;
+
+// Закреплять ли рабочие потоки за ядрами (--pin). Таблицы выделяются в самом рабочем
+// потоке, поэтому после закрепления первое касание кладёт их на узел NUMA этого ядра.
+bool pin_threads = false;
+
+// Размер виртуального резерва арены потока; память занимается только при касании.
+// Явные большие страницы резервируются из пула ядра сразу (иначе при нехватке пула
+// касание даёт SIGBUS), поэтому их арена меньше.
+const size_t ARENA_BYTES = size_t(1) << 32;
+const size_t EXPLICIT_ARENA_BYTES = size_t(1) << 28;
+const size_t HUGE_PAGE_BYTES = size_t(2) << 20;
+
+// Арена потока для таблиц сумм: один mmap, выровненный на 2 МБ и отданный под
+// прозрачные (madvise) или явные (MAP_HUGETLB) большие страницы, чтобы случайный
+// доступ к таблицам в десятки мегабайт не упирался в промахи TLB. Выделение —
+// сдвиг указателя, освобождение — сброс между задачами.
+class HugePageArena {
+public:
+    explicit HugePageArena(HugePages mode) {
+        int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+        if (mode == HugePages::Explicit) {
+            mapping_ = mmap(nullptr, EXPLICIT_ARENA_BYTES, PROT_READ | PROT_WRITE, flags | MAP_HUGETLB, -1, 0);
+            if (mapping_ != MAP_FAILED) {
+                mapped_ = capacity_ = EXPLICIT_ARENA_BYTES;
+                base_ = static_cast<char*>(mapping_);
+                return;
+            }
             lock_guard<mutex> lock(mtx);
-            if (problem_indices.empty()) break;
-            problem_index = problem_indices.front();
-            problem_indices.pop();
+            cerr << "Явные большие страницы недоступны, используются прозрачные" << endl;
+        }
+        mapped_ = ARENA_BYTES + HUGE_PAGE_BYTES;
+        mapping_ = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, flags | MAP_NORESERVE, -1, 0);
+        if (mapping_ == MAP_FAILED) {
+            mapping_ = nullptr;
+            return;
         }
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(mapping_) + HUGE_PAGE_BYTES - 1) & ~(HUGE_PAGE_BYTES - 1);
+        base_ = reinterpret_cast<char*>(aligned);
+        capacity_ = ARENA_BYTES;
+        madvise(base_, capacity_, MADV_HUGEPAGE);
+    }
 
-        long long target_weight = problems[problem_index].back();
-        auto [first_time, all_time, solution_count] = solve_knapsack_bruteforce(problems[problem_index], target_weight);
+    ~HugePageArena() {
+        if (mapping_) munmap(mapping_, mapped_);
+    }
 
-        lock_guard<mutex> lock(mtx);
-        results[problem_index] = {problem_index + 1, first_time, all_time, solution_count};
-        cout << "Задача " << (problem_index + 1) << " решена: найдено " << solution_count << " решений" << endl;
+    void* allocate(size_t bytes) {
+        size_t start = (offset_ + 63) & ~size_t(63);
+        if (!base_ || start + bytes > capacity_) return nullptr;
+        offset_ = start + bytes;
+        return base_ + start;
+    }
+
+    bool owns(const void* p) const { return base_ && p >= base_ && p < base_ + capacity_; }
+    void reset() { offset_ = 0; }
+
+private:
+    void* mapping_ = nullptr;
+    size_t mapped_ = 0;
+    char* base_ = nullptr;
+    size_t capacity_ = 0;
+    size_t offset_ = 0;
+};
+
+// Арена текущего рабочего потока; без неё таблицы берутся из обычной кучи.
+thread_local HugePageArena* current_arena = nullptr;
+
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+    ArenaAllocator() = default;
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>&) {}
+
+    T* allocate(size_t n) {
+        if (current_arena) {
+            if (void* p = current_arena->allocate(n * sizeof(T))) return static_cast<T*>(p);
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t) {
+        if (current_arena && current_arena->owns(p)) return;
+        ::operator delete(p);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U>&) const { return false; }
+};
+
+using SumTable = vector<long long, ArenaAllocator<long long>>;
+
+// Закрепляет вызывающий поток за index-м из доступных процессу ядер.
+void pin_to_core(unsigned int index) {
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return;
+    int cores = CPU_COUNT(&allowed);
+    if (cores == 0) return;
+    int wanted = index % cores;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+        if (!CPU_ISSET(cpu, &allowed) || wanted-- > 0) continue;
+        cpu_set_t single;
+        CPU_ZERO(&single);
+        CPU_SET(cpu, &single);
+        pthread_setaffinity_np(pthread_self(), sizeof(single), &single);
+        return;
     }
 }
 
-void save_results(const vector<Result>& results, const string& filename) {
-    ofstream file(filename);
-    if (file.is_open()) {
-        file << "Problem Number,First Solution Time (s),All Solutions Time (s),Number of Solutions\n";
-        for (const auto& result : results) {
-            file << result.problem_number << ","
-                 << (result.first_solution_time > 0 ? to_string(result.first_solution_time) : "N/A") << ","
-                 << result.all_solutions_time << ","
-                 << result.solutions_count << "\n";
+SumTable subset_sums(const vector<long long>& weights, int from, int to) {
+    SumTable sums(size_t(1) << (to - from), 0);
+    for (int i = from; i < to; ++i) {
+        size_t half = size_t(1) << (i - from);
+        for (size_t mask = 0; mask < half; ++mask) {
+            sums[half + mask] = sums[mask] + weights[i];
         }
-        file.close();
-    } else {
-        cerr << "Не удалось открыть файл: " << filename << endl;
     }
+    return sums;
 }
 
-int main() {
-    for (int i = 1; i <= 4; ++i) {
-        string input_filename = "knapsack_problems_" + to_string(i) + ".csv";
-        string output_filename = "knapsack_solutions_" + to_string(i) + ".csv";
+// Выдаёт суммы first[i] + second[j] по возрастанию (или по убыванию), храня в куче
+// по одному кандидату на каждый элемент first: памяти O(|first|), а не O(|first| * |second|).
+class PairSumStream {
+public:
+    PairSumStream(SumTable first, SumTable second, bool ascending)
+        : first_(move(first)), second_(move(second)), heap_(Compare{ascending}) {
+        sort(first_.begin(), first_.end());
+        sort(second_.begin(), second_.end());
+        if (!ascending) {
+            reverse(first_.begin(), first_.end());
+            reverse(second_.begin(), second_.end());
+        }
+        for (size_t i = 0; i < first_.size(); ++i) {
+            heap_.push({first_[i] + second_[0], i, 0});
+        }
+    }
 
-        vector<vector<long long>> problems = load_problems(input_filename);
-        vector<Result> results(problems.size());
+    bool empty() const { return heap_.empty(); }
+    long long top() const { return heap_.top().sum; }
 
-        queue<int> problem_indices;
-        for (size_t j = 0; j < problems.size(); ++j) {
-            problem_indices.push(j);
+    void pop() {
+        Entry entry = heap_.top();
+        heap_.pop();
+        if (entry.j + 1 < second_.size()) {
+            heap_.push({first_[entry.i] + second_[entry.j + 1], entry.i, entry.j + 1});
         }
+    }
 
-        unsigned int num_threads = thread::hardware_concurrency();
-        if (num_threads == 0) num_threads = 4;
-        cout << "Обрабатываем " << input_filename << " с использованием " << num_threads << " потоков." << endl;
+    // Снимает все одинаковые суммы с вершины и возвращает их количество.
+    long long pop_equal() {
+        long long value = top();
+        long long count = 0;
+        while (!empty() && top() == value) {
+            pop();
+            ++count;
+        }
+        return count;
+    }
 
-        vector<thread> threads;
-        for (unsigned int j = 0; j < num_threads; ++j) {
-            threads.emplace_back(worker, ref(problem_indices), cref(problems), ref(results));
+private:
+    struct Entry {
+        long long sum;
+        size_t i;
+        size_t j;
+    };
+    struct Compare {
+        bool ascending;
+        bool operator()(const Entry& a, const Entry& b) const {
+            return ascending ? a.sum > b.sum : a.sum < b.sum;
         }
+    };
 
-        for (auto& t : threads) {
-            t.join();
+    SumTable first_;
+    SumTable second_;
+    priority_queue<Entry, vector<Entry>, Compare> heap_;
+};
+
+// Алгоритм Шрёппеля–Шамира: веса делятся на четыре четверти, суммы левой половины
+// идут по возрастанию, правой по убыванию, и они сводятся двумя указателями.
+// Память O(2^(n/4)), время O(2^(n/2) log).
+tuple<double, double, int> solve_knapsack_schroeppel_shamir(const vector<long long>& items, long long target_weight) {
+    int n = items.size() - 1;
+    vector<long long> weights(items.begin(), items.end() - 1);
+    int q1 = n / 4, q2 = n / 2, q3 = n / 2 + (n - n / 2) / 2;
+
+    double first_solution_time = 0.0;
+    long long solutions_count = 0;
+
+    auto start_time = high_resolution_clock::now();
+
+    PairSumStream left(subset_sums(weights, 0, q1), subset_sums(weights, q1, q2), true);
+    PairSumStream right(subset_sums(weights, q2, q3), subset_sums(weights, q3, n), false);
+
+    while (!left.empty() && !right.empty()) {
+        long long sum = left.top() + right.top();
+        if (sum < target_weight) {
+            left.pop();
+        } else if (sum > target_weight) {
+            right.pop();
+        } else {
+            solutions_count += left.pop_equal() * right.pop_equal();
+            if (first_solution_time == 0.0) {
+                first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+            }
         }
+    }
+    // Пустое подмножество полный перебор не рассматривает.
+    if (target_weight == 0) solutions_count--;
 
-        save_results(results, output_filename);
-        cout << "Результаты сохранены в " << output_filename << endl;
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, static_cast<int>(solutions_count));
+}
+
+// Число запусков LLL с разными перестановками весов, прежде чем сдаться.
+const int LLL_ATTEMPTS = 8;
+
+// LLL-редукция строк basis (линейно независимых) с параметром delta.
+// Базис целочисленный, ортогонализация Грама–Шмидта ведётся в long double
+// и пересчитывается с места перестановки.
+void lll_reduce(vector<vector<long long>>& basis, long double delta = 0.99L) {
+    int m = basis.size(), d = basis[0].size();
+    vector<vector<long double>> bstar(m, vector<long double>(d));
+    vector<vector<long double>> mu(m, vector<long double>(m, 0.0L));
+    vector<long double> norms(m, 0.0L);
+
+    auto gram_schmidt = [&](int from) {
+        for (int i = from; i < m; ++i) {
+            for (int c = 0; c < d; ++c) bstar[i][c] = basis[i][c];
+            for (int j = 0; j < i; ++j) {
+                long double dot = 0.0L;
+                for (int c = 0; c < d; ++c) dot += basis[i][c] * bstar[j][c];
+                mu[i][j] = norms[j] > 0 ? dot / norms[j] : 0.0L;
+                for (int c = 0; c < d; ++c) bstar[i][c] -= mu[i][j] * bstar[j][c];
+            }
+            norms[i] = 0.0L;
+            for (int c = 0; c < d; ++c) norms[i] += bstar[i][c] * bstar[i][c];
+        }
+    };
+
+    gram_schmidt(0);
+    int k = 1;
+    while (k < m) {
+        for (int j = k - 1; j >= 0; --j) {
+            long long q = llroundl(mu[k][j]);
+            if (q == 0) continue;
+            for (int c = 0; c < d; ++c) {
+                basis[k][c] = static_cast<long long>(static_cast<__int128>(basis[k][c]) - static_cast<__int128>(q) * basis[j][c]);
+            }
+            for (int i = 0; i < j; ++i) mu[k][i] -= q * mu[j][i];
+            mu[k][j] -= q;
+        }
+        if (norms[k] >= (delta - mu[k][k - 1] * mu[k][k - 1]) * norms[k - 1]) {
+            ++k;
+        } else {
+            swap(basis[k], basis[k - 1]);
+            gram_schmidt(k - 1);
+            k = max(k - 1, 1);
+        }
+    }
+}
+
+// Решение задачи о сумме подмножества редукцией решётки (вложение Лагариаса–Одлыжко
+// в варианте CJLOSS). Строки базиса: b_i = (2e_i, 0, N*a_i), b_{n+1} = (1..1, 1, N*s)
+// и при modulus > 0 ещё (0..0, 0, N*M). Решение x даёт короткий вектор с координатами ±1
+// и нулём в последнем столбце. Перебираются несколько случайных перестановок весов;
+// в solutions попадают только проверенные решения (маски по исходному порядку).
+void lll_subset_sum(const vector<long long>& weights, long long target_weight, long long modulus,
+                    set<vector<char>>& solutions) {
+    int n = weights.size();
+    long long scale = n + 1;
+
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    mt19937 gen(12345);
+
+    for (int attempt = 0; attempt < LLL_ATTEMPTS; ++attempt) {
+        if (attempt > 0) shuffle(order.begin(), order.end(), gen);
+
+        vector<vector<long long>> basis;
+        for (int i = 0; i < n; ++i) {
+            vector<long long> row(n + 2, 0);
+            row[i] = 2;
+            row[n + 1] = scale * weights[order[i]];
+            basis.push_back(row);
+        }
+        vector<long long> target_row(n + 2, 1);
+        target_row[n + 1] = scale * target_weight;
+        basis.push_back(target_row);
+        if (modulus > 0) {
+            vector<long long> modulus_row(n + 2, 0);
+            modulus_row[n + 1] = scale * modulus;
+            basis.push_back(modulus_row);
+        }
+
+        lll_reduce(basis);
+
+        for (const auto& v : basis) {
+            if (v[n + 1] != 0 || (v[n] != 1 && v[n] != -1)) continue;
+            bool binary = all_of(v.begin(), v.begin() + n, [](long long x) { return x == 1 || x == -1; });
+            if (!binary) continue;
+
+            vector<char> mask(n, 0);
+            long long sum = 0;
+            for (int i = 0; i < n; ++i) {
+                if (-v[i] * v[n] == 1) {
+                    mask[order[i]] = 1;
+                    sum = modulus > 0 ? (sum + weights[order[i]]) % modulus : sum + weights[order[i]];
+                }
+            }
+            long long expected = modulus > 0 ? target_weight % modulus : target_weight;
+            if (sum == expected && count(mask.begin(), mask.end(), 1) > 0) solutions.insert(mask);
+        }
+        if (!solutions.empty()) return;
+    }
+}
+
+// Метод редукции решётки: быстро находит решение на задачах малой плотности, но не
+// доказывает его отсутствие. Число решений здесь — число найденных, а не всех.
+// Пробуется и дополнение цели (сумма всех весов минус s), так как LLL часто находит
+// более короткое из двух.
+tuple<double, double, int> solve_knapsack_lll(const vector<long long>& items, long long target_weight) {
+    vector<long long> weights(items.begin(), items.end() - 1);
+
+    double first_solution_time = 0.0;
+    auto start_time = high_resolution_clock::now();
+
+    set<vector<char>> solutions;
+    lll_subset_sum(weights, target_weight, engine_modulus, solutions);
+    if (solutions.empty()) {
+        long long complement = accumulate(weights.begin(), weights.end(), 0LL) - target_weight;
+        if (engine_modulus > 0) complement = (complement % engine_modulus + engine_modulus) % engine_modulus;
+        set<vector<char>> complements;
+        lll_subset_sum(weights, complement, engine_modulus, complements);
+        for (auto mask : complements) {
+            for (char& bit : mask) bit = !bit;
+            if (count(mask.begin(), mask.end(), 1) > 0) solutions.insert(mask);
+        }
+    }
+    if (!solutions.empty()) {
+        first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    }
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, static_cast<int>(solutions.size()));
+}
+
+// Наибольшая сумма весов, для которой строятся битовые множества достижимых сумм
+// (n + 1 слоёв по 2 МБ при n = 24).
+const long long BITSET_MAX_TOTAL = 1LL << 24;
+
+// dst = src | (src << shift) над словами по 64 бита.
+void shift_or(const vector<uint64_t>& src, vector<uint64_t>& dst, long long shift) {
+    size_t words = src.size();
+    size_t word_shift = shift / 64;
+    int bit_shift = shift % 64;
+    size_t i = 0;
+    for (; i < min(words, word_shift + 1); ++i) {
+        uint64_t moved = i >= word_shift ? src[i - word_shift] << bit_shift : 0;
+        dst[i] = src[i] | moved;
+    }
+#ifdef __AVX2__
+    if (bit_shift != 0) {
+        __m256i left = _mm256_set1_epi64x(bit_shift);
+        __m256i right = _mm256_set1_epi64x(64 - bit_shift);
+        for (; i + 4 <= words; i += 4) {
+            __m256i cur = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[i]));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[i - word_shift]));
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&src[i - word_shift - 1]));
+            __m256i moved = _mm256_or_si256(_mm256_sllv_epi64(hi, left), _mm256_srlv_epi64(lo, right));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(&dst[i]), _mm256_or_si256(cur, moved));
+        }
+    }
+#endif
+    for (; i < words; ++i) {
+        uint64_t moved = src[i - word_shift] << bit_shift;
+        if (bit_shift != 0) moved |= src[i - word_shift - 1] >> (64 - bit_shift);
+        dst[i] = src[i] | moved;
+    }
+}
+
+// Слои достижимых сумм: layers[i] — суммы подмножеств первых i весов.
+// Строятся один раз на вектор весов и переиспользуются потоком для всех целей
+// с теми же весами.
+struct ReachableSums {
+    vector<long long> weights;
+    vector<vector<uint64_t>> layers;
+};
+
+const ReachableSums& reachable_sums(const vector<long long>& weights, long long total) {
+    thread_local ReachableSums cached;
+    if (cached.weights == weights && !cached.layers.empty()) return cached;
+
+    size_t words = static_cast<size_t>(total / 64 + 1);
+    cached.weights = weights;
+    cached.layers.assign(weights.size() + 1, vector<uint64_t>(words, 0));
+    cached.layers[0][0] = 1;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        shift_or(cached.layers[i], cached.layers[i + 1], weights[i]);
+    }
+    return cached;
+}
+
+// Битовые множества достижимых сумм (сдвиг-ИЛИ по словам) для задач с небольшой суммой
+// весов. Отвечает, достижима ли цель, и восстанавливает свидетеля обратным ходом по слоям.
+// Число решений — 1, если решение есть (свидетель проверяется), иначе 0. При большой сумме
+// весов или отрицательных весах используется блочный перебор.
+tuple<double, double, int> solve_knapsack_bitset(const vector<long long>& items, long long target_weight) {
+    vector<long long> weights(items.begin(), items.end() - 1);
+    long long total = 0;
+    for (long long w : weights) {
+        if (w < 0) return solve_knapsack_blocked(items, target_weight);
+        total += w;
+    }
+    if (total > BITSET_MAX_TOTAL) return solve_knapsack_blocked(items, target_weight);
+
+    double first_solution_time = 0.0;
+    int solutions_count = 0;
+    auto start_time = high_resolution_clock::now();
+
+    auto bit = [](const vector<uint64_t>& layer, long long sum) { return (layer[sum / 64] >> (sum % 64)) & 1; };
+
+    const ReachableSums& reachable = reachable_sums(weights, total);
+    int n = weights.size();
+    if (target_weight > 0 && target_weight <= total && bit(reachable.layers[n], target_weight)) {
+        long long rest = target_weight;
+        for (int i = n - 1; i >= 0 && rest > 0; --i) {
+            if (!bit(reachable.layers[i], rest)) rest -= weights[i];
+        }
+        if (rest == 0) {
+            solutions_count = 1;
+            first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+        }
+    }
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, solutions_count);
+}
+
+// Допустимая относительная погрешность приближённого метода (--epsilon=E).
+double approx_epsilon = 0.01;
+
+struct PartialSum {
+    long long sum;
+    uint64_t mask;
+};
+
+// Приближённая схема для суммы подмножеств: отсортированный список достижимых сумм
+// (не больше цели) после каждого веса прореживается с шагом 1 + ε / (2n). Возвращает
+// сумму, не меньшую (1 − ε) от наилучшей достижимой, и маску соответствующего подмножества.
+// Работает для n ≤ 64 и неотрицательных весов.
+long long approximate_subset_sum(const vector<long long>& weights, long long target_weight, double epsilon,
+                                 uint64_t& best_mask) {
+    int n = weights.size();
+    double delta = epsilon / (2.0 * n);
+    vector<PartialSum> sums = {{0, 0}}, shifted, merged;
+
+    for (int i = 0; i < n; ++i) {
+        shifted.clear();
+        for (const PartialSum& p : sums) {
+            if (p.sum + weights[i] <= target_weight) shifted.push_back({p.sum + weights[i], p.mask | (1ULL << i)});
+        }
+
+        merged.clear();
+        merge(sums.begin(), sums.end(), shifted.begin(), shifted.end(), back_inserter(merged),
+              [](const PartialSum& a, const PartialSum& b) { return a.sum < b.sum; });
+
+        sums.clear();
+        for (const PartialSum& p : merged) {
+            if (sums.empty() || p.sum > sums.back().sum * (1.0 + delta)) sums.push_back(p);
+            else if (p.sum == target_weight) sums.back() = p;
+        }
+    }
+
+    best_mask = sums.back().mask;
+    return sums.back().sum;
+}
+
+// Ответ приближённого метода на последнюю задачу потока: лучшая сумма и маска её
+// подмножества. Рабочий поток сбрасывает его перед задачей и забирает после.
+struct Approximation {
+    bool valid = false;
+    long long best_sum = 0;
+    uint64_t mask = 0;
+};
+thread_local Approximation last_approximation;
+
+// Приближённый метод с гарантией (1 − ε): число решений — 1, если найденная сумма
+// совпала с целью, иначе 0. Лучшая сумма и подмножество (проверенное пересчётом)
+// остаются в last_approximation и сохраняются в knapsack_approximations_N.csv.
+tuple<double, double, int> solve_knapsack_approximate(const vector<long long>& items, long long target_weight) {
+    last_approximation = Approximation();
+    vector<long long> weights(items.begin(), items.end() - 1);
+    if (weights.size() > 64 || any_of(weights.begin(), weights.end(), [](long long w) { return w < 0; })) {
+        return solve_knapsack_branch_and_bound_first(items, target_weight);
+    }
+
+    double first_solution_time = 0.0;
+    int solutions_count = 0;
+    auto start_time = high_resolution_clock::now();
+
+    uint64_t mask = 0;
+    long long best = approximate_subset_sum(weights, target_weight, approx_epsilon, mask);
+    long long mask_sum = 0;
+    for (size_t i = 0; i < weights.size(); ++i) {
+        if ((mask >> i) & 1) mask_sum += weights[i];
+    }
+    if (mask_sum != best) {
+        lock_guard<mutex> lock(mtx);
+        cerr << "Приближение: маска даёт сумму " << mask_sum << " вместо " << best << endl;
+    } else {
+        last_approximation = {true, best, mask};
+        if (best == target_weight && mask != 0) {
+            solutions_count = 1;
+            first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+        }
+    }
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, solutions_count);
+}
+
+// Встреча посередине для сумм по модулю engine_modulus: суммы правой половины
+// сортируются по остатку, для каждой суммы левой ищется дополняющий остаток.
+// Считает все непустые подмножества, как и полный перебор в all_sol_mod.cpp.
+// Без модуля (engine_modulus ≤ 0) задача обычная, и её решает метод ss.
+tuple<double, double, int> solve_knapsack_modular(const vector<long long>& items, long long target_weight) {
+    long long modulus = engine_modulus;
+    if (modulus <= 0) return solve_knapsack_schroeppel_shamir(items, target_weight);
+    int n = items.size() - 1;
+    vector<long long> weights(items.begin(), items.end() - 1);
+    auto reduce = [modulus](long long x) { return (x % modulus + modulus) % modulus; };
+
+    double first_solution_time = 0.0;
+    long long solutions_count = 0;
+    auto start_time = high_resolution_clock::now();
+
+    SumTable left = subset_sums(weights, 0, n / 2);
+    SumTable right = subset_sums(weights, n / 2, n);
+    for (long long& sum : right) sum = reduce(sum);
+    sort(right.begin(), right.end());
+
+    long long need_total = reduce(target_weight);
+    for (long long sum : left) {
+        long long need = reduce(need_total - sum);
+        auto range = equal_range(right.begin(), right.end(), need);
+        if (range.first != range.second) {
+            solutions_count += range.second - range.first;
+            if (first_solution_time == 0.0) {
+                first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+            }
+        }
+    }
+    if (need_total == 0) solutions_count--;
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, static_cast<int>(solutions_count));
+}
+
+using Engine = tuple<double, double, int> (*)(const vector<long long>&, long long);
+
+Engine select_engine(const string& name) {
+    if (name == "bruteforce") return solve_knapsack_bruteforce;
+    if (name == "blocked") return solve_knapsack_blocked;
+    if (name == "bnb") return solve_knapsack_branch_and_bound;
+    if (name == "bnb-first") return solve_knapsack_branch_and_bound_first;
+    if (name == "ss") return solve_knapsack_schroeppel_shamir;
+    if (name == "lll") return solve_knapsack_lll;
+    if (name == "bitset") return solve_knapsack_bitset;
+    if (name == "approx") return solve_knapsack_approximate;
+    if (name == "modular") return solve_knapsack_modular;
+    return nullptr;
+}
+
+// Что требуется от метода (--mode=...): число всех решений, наличие решения
+// или лучшая достижимая сумма с гарантией точности. Каждый следующий режим
+// допускает все методы предыдущего.
+enum class SolveMode { Count, Exists, BestEffort };
+
+// Самый слабый режим, ответ которого даёт метод: bitset и bnb-first сообщают лишь
+// наличие решения, approx и lll — найденное, а не все решения. Явно выбранный метод
+// проверяется по --mode так же, как планировщик отбирает кандидатов.
+SolveMode engine_mode(const string& name) {
+    if (name == "bitset" || name == "bnb-first") return SolveMode::Exists;
+    if (name == "approx" || name == "lll") return SolveMode::BestEffort;
+    return SolveMode::Count;
+}
+
+struct ProblemProfile {
+    int n;
+    long long max_weight;
+    long long total;
+    double density;
+    long long modulus;
+    bool has_negative;
+};
+
+struct Plan {
+    string engine_name;
+    Engine engine;
+    double predicted_cost;
+};
+
+ProblemProfile profile_problem(const vector<long long>& items, long long modulus) {
+    ProblemProfile profile = {static_cast<int>(items.size()) - 1, 0, 0, 0.0, modulus, false};
+    for (auto it = items.begin(); it != items.end() - 1; ++it) {
+        profile.max_weight = max(profile.max_weight, llabs(*it));
+        profile.total += *it;
+        if (*it < 0) profile.has_negative = true;
+    }
+    long long bound = modulus > 0 ? modulus : profile.max_weight;
+    profile.density = bound > 1 ? profile.n / log2(static_cast<double>(bound)) : profile.n;
+    return profile;
+}
+
+// Грубая модель времени (в секундах, один поток), откалиброванная на задачах с n = 24.
+// LLL сюда не входит: он не доказывает отсутствие решения, так что в режиме exists
+// его «0 решений» ничего не значит, а стоит он дороже ss — при 56-битных весах уже
+// при n = 32 (плотность 0.57) восемь попыток занимают секунды и не находят решения,
+// при n = 48 около 18 с. Его можно выбрать только явно: --engine=lll.
+Plan plan_problem(const ProblemProfile& p, SolveMode mode) {
+    vector<Plan> candidates;
+    auto add = [&](const string& name, double cost) { candidates.push_back({name, select_engine(name), cost}); };
+    double n = p.n;
+
+    if (p.modulus > 0) {
+        add("modular", 1.2e-7 * ldexp(1.0, p.n / 2 + 1));
+    } else {
+        if (p.n <= 64) {
+            add("bruteforce", 1.8e-8 * ldexp(1.0, p.n));
+            add("blocked", 6e-10 * ldexp(1.0, p.n));
+        }
+        add("ss", 1.2e-7 * ldexp(1.0, (p.n + 1) / 2));
+        if (mode != SolveMode::Count && !p.has_negative && p.total <= BITSET_MAX_TOTAL) {
+            add("bitset", 4e-10 * n * (p.total / 64 + 1));
+        }
+        if (mode == SolveMode::BestEffort && !p.has_negative && p.n <= 64) {
+            double list_size = min(ldexp(1.0, p.n), log(max(2.0, double(p.total))) * 2.0 * n / approx_epsilon);
+            add("approx", 5e-10 * n * list_size);
+        }
+    }
+
+    return *min_element(candidates.begin(), candidates.end(),
+                        [](const Plan& a, const Plan& b) { return a.predicted_cost < b.predicted_cost; });
+}
+
+struct Result {
+    int problem_number;
+    double first_solution_time;
+    double all_solutions_time;
+    int solutions_count;
+    // Заполняются только приближённым методом.
+    bool approximated = false;
+    long long best_sum = 0;
+    uint64_t best_mask = 0;
+};
+
+// Среднее и дисперсия методом Уэлфорда; накопители разных потоков сливаются формулой Чана.
+// Дисперсия выборочная (делитель n - 1), как в pandas.
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double x) {
+        count++;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    void merge(const RunningStats& other) {
+        if (other.count == 0) return;
+        uint64_t total = count + other.count;
+        double delta = other.mean - mean;
+        mean += delta * other.count / total;
+        m2 += other.m2 + delta * delta * count * other.count / total;
+        count = total;
+    }
+
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double stddev() const { return sqrt(variance()); }
+};
+
+// Гистограмма времени с логарифмическими корзинами (как HDR): на каждую степень двойки
+// TIME_SUB_BUCKETS корзин, поэтому квантиль известен с относительной точностью ~1.6%
+// на всём диапазоне от наносекунд до часов при постоянной памяти.
+const int TIME_MIN_EXPONENT = -30;
+const int TIME_MAX_EXPONENT = 13;
+const int TIME_SUB_BUCKETS = 32;
+
+struct TimeHistogram {
+    array<uint64_t, (TIME_MAX_EXPONENT - TIME_MIN_EXPONENT) * TIME_SUB_BUCKETS> buckets{};
+    uint64_t zeros = 0;
+
+    void add(double seconds) {
+        if (seconds <= 0) {
+            zeros++;
+            return;
+        }
+        int exponent;
+        double mantissa = frexp(seconds, &exponent);
+        exponent = min(max(exponent, TIME_MIN_EXPONENT), TIME_MAX_EXPONENT - 1);
+        int sub = min(TIME_SUB_BUCKETS - 1, static_cast<int>((mantissa - 0.5) * 2 * TIME_SUB_BUCKETS));
+        buckets[(exponent - TIME_MIN_EXPONENT) * TIME_SUB_BUCKETS + max(0, sub)]++;
+    }
+
+    void merge(const TimeHistogram& other) {
+        for (size_t i = 0; i < buckets.size(); ++i) buckets[i] += other.buckets[i];
+        zeros += other.zeros;
+    }
+
+    double quantile(double q) const {
+        uint64_t total = zeros;
+        for (uint64_t b : buckets) total += b;
+        if (total == 0) return 0.0;
+        uint64_t rank = static_cast<uint64_t>(ceil(q * total));
+        uint64_t seen = zeros;
+        if (seen >= rank) return 0.0;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                int exponent = static_cast<int>(i / TIME_SUB_BUCKETS) + TIME_MIN_EXPONENT;
+                double mantissa = 0.5 + (i % TIME_SUB_BUCKETS + 0.5) / (2.0 * TIME_SUB_BUCKETS);
+                return ldexp(mantissa, exponent);
+            }
+        }
+        return 0.0;
+    }
+};
+
+// Сводка по файлу. Каждый рабочий поток ведёт свою копию без блокировок, копии
+// сливаются после завершения потоков.
+struct FileStats {
+    RunningStats first_time, all_time;
+    TimeHistogram first_histogram, all_histogram;
+    uint64_t solved = 0;
+
+    void add(const Result& result) {
+        all_time.add(result.all_solutions_time);
+        all_histogram.add(result.all_solutions_time);
+        if (result.solutions_count > 0) {
+            solved++;
+            first_time.add(result.first_solution_time);
+            first_histogram.add(result.first_solution_time);
+        }
+    }
+
+    void merge(const FileStats& other) {
+        first_time.merge(other.first_time);
+        all_time.merge(other.all_time);
+        first_histogram.merge(other.first_histogram);
+        all_histogram.merge(other.all_histogram);
+        solved += other.solved;
+    }
+};
+
+struct FileSummary {
+    string input_filename;
+    long long a_max;
+    FileStats stats;
+};
+
+// Дополняет строку пробелами до width символов (setw считает байты, а не буквы UTF-8).
+string pad(const string& text, size_t width) {
+    size_t letters = count_if(text.begin(), text.end(), [](char c) { return (c & 0xC0) != 0x80; });
+    return text + string(width > letters ? width - letters : 0, ' ');
+}
+
+void print_summary(const vector<FileSummary>& summaries) {
+    auto print_table = [&](const string& title, const RunningStats FileStats::*stats,
+                           const TimeHistogram FileStats::*histogram) {
+        cout << "\n" << title << ":" << endl;
+        cout << string(118, '-') << endl;
+        cout << pad("Файл", 26) << pad("A_MAX", 12) << pad("Задач", 8) << pad("Доля", 10) << pad("Среднее", 12)
+             << pad("Дисперсия", 12) << pad("СКО", 12) << pad("p50", 12) << pad("p90", 12) << pad("p99", 12) << endl;
+        cout << string(118, '-') << endl;
+        for (const auto& summary : summaries) {
+            const FileStats& file_stats = summary.stats;
+            const RunningStats& running = file_stats.*stats;
+            const TimeHistogram& times = file_stats.*histogram;
+            double share = file_stats.all_time.count ? double(file_stats.solved) / file_stats.all_time.count : 0.0;
+            cout << left << setw(26) << summary.input_filename << setw(12) << summary.a_max
+                 << setw(8) << file_stats.all_time.count << setw(10) << share
+                 << setw(12) << running.mean << setw(12) << running.variance() << setw(12) << running.stddev()
+                 << setw(12) << times.quantile(0.5) << setw(12) << times.quantile(0.9) << setw(12) << times.quantile(0.99)
+                 << endl;
+        }
+        cout << string(118, '-') << endl;
+    };
+    print_table("Время нахождения одного решения (задачи с решением)", &FileStats::first_time, &FileStats::first_histogram);
+    print_table("Время нахождения всех решений", &FileStats::all_time, &FileStats::all_histogram);
+}
+
+// Контрольная точка: заголовок (магия, версия, число задач) и по записи на каждую
+// решённую задачу. Записи дописываются сразу после решения, поэтому при
+// прерывании теряются только задачи, которые решались в этот момент.
+const char CHECKPOINT_MAGIC[4] = {'K', 'S', 'C', 'P'};
+const uint32_t CHECKPOINT_VERSION = 2;
+
+#pragma pack(push, 1)
+struct CheckpointRecord {
+    int32_t problem_index;
+    double first_solution_time;
+    double all_solutions_time;
+    int32_t solutions_count;
+    uint8_t approximated;
+    int64_t best_sum;
+    uint64_t best_mask;
+};
+#pragma pack(pop)
+
+vector<bool> load_checkpoint(const string& filename, vector<Result>& results) {
+    vector<bool> done(results.size(), false);
+    ifstream file(filename, ios::binary);
+    if (!file.is_open()) return done;
+
+    char magic[4];
+    uint32_t version = 0, count = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    file.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!file || memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        version != CHECKPOINT_VERSION || count != results.size()) {
+        cerr << "Контрольная точка " << filename << " не подходит, начинаем заново" << endl;
+        return done;
+    }
+
+    CheckpointRecord record;
+    while (file.read(reinterpret_cast<char*>(&record), sizeof(record))) {
+        if (record.problem_index < 0 || record.problem_index >= static_cast<int32_t>(results.size())) break;
+        results[record.problem_index] = {record.problem_index + 1, record.first_solution_time,
+                                         record.all_solutions_time, record.solutions_count,
+                                         record.approximated != 0, record.best_sum, record.best_mask};
+        done[record.problem_index] = true;
+    }
+    return done;
+}
+
+void write_checkpoint_header(ofstream& file, size_t problem_count) {
+    uint32_t count = static_cast<uint32_t>(problem_count);
+    file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    file.write(reinterpret_cast<const char*>(&CHECKPOINT_VERSION), sizeof(CHECKPOINT_VERSION));
+    file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    file.flush();
+}
+
+void append_checkpoint(ofstream& file, int problem_index, const Result& result) {
+    CheckpointRecord record = {problem_index, result.first_solution_time, result.all_solutions_time,
+                               result.solutions_count, result.approximated, result.best_sum, result.best_mask};
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    file.flush();
+}
+
+// Файл решений (--enumerate): заголовок (магия, версия, флаг сжатия), затем по блоку
+// на задачу: номер задачи, n, число найденных и записанных решений, длина данных и сами
+// маски по возрастанию. Без сжатия маска занимает (n + 7) / 8 байт, со сжатием (--compress)
+// пишется разность с предыдущей маской в формате varint.
+const char WITNESS_MAGIC[4] = {'K', 'S', 'W', 'T'};
+const uint32_t WITNESS_VERSION = 1;
+// Маски решений 64-битные, поэтому перечисляются только задачи с n ≤ 64; остальные
+// решаются выбранным методом без записи решений.
+const int WITNESS_MAX_N = 64;
+
+#pragma pack(push, 1)
+struct WitnessBlockHeader {
+    int32_t problem_index;
+    uint8_t n;
+    uint64_t solutions_count;
+    uint64_t stored_count;
+    uint64_t payload_size;
+};
+#pragma pack(pop)
+
+// Буферизованный приёмник блоков: рабочие потоки только ставят готовый блок в очередь,
+// а запись на диск ведёт отдельный поток, так что перебор не ждёт ввода-вывода.
+// Вместе с блоком передаётся действие, которое выполняется после того, как блок
+// записан и сброшен в файл: так задача попадает в контрольную точку не раньше своего
+// блока. При продолжении (done != nullptr) файл сначала приводится к контрольной точке.
+class WitnessSink {
+public:
+    WitnessSink(const string& filename, bool compressed, uint64_t max_solutions, vector<bool>* done)
+        : compressed_(compressed), max_solutions_(max_solutions) {
+        if (done) {
+            recover(filename, *done);
+            file_.open(filename, ios::binary | ios::app);
+        } else {
+            file_.open(filename, ios::binary | ios::trunc);
+            write_header(file_);
+        }
+        writer_ = thread([this] { write_loop(); });
+    }
+
+    ~WitnessSink() {
+        {
+            lock_guard<mutex> lock(queue_mutex_);
+            closing_ = true;
+        }
+        ready_.notify_one();
+        writer_.join();
+    }
+
+    bool compressed() const { return compressed_; }
+    uint64_t max_solutions() const { return max_solutions_; }
+
+    void submit(vector<char> block, function<void()> on_written) {
+        {
+            lock_guard<mutex> lock(queue_mutex_);
+            blocks_.push_back({move(block), move(on_written)});
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void write_header(ofstream& file) const {
+        uint8_t flag = compressed_;
+        file.write(WITNESS_MAGIC, sizeof(WITNESS_MAGIC));
+        file.write(reinterpret_cast<const char*>(&WITNESS_VERSION), sizeof(WITNESS_VERSION));
+        file.write(reinterpret_cast<const char*>(&flag), sizeof(flag));
+    }
+
+    // Оставляет в файле только целые блоки задач из контрольной точки (по одному на
+    // задачу): недописанный при прерывании хвост и блоки, чья запись в контрольную
+    // точку не успела, отбрасываются. Задачи без блока снимаются с done и решаются заново.
+    void recover(const string& filename, vector<bool>& done) const {
+        ifstream in(filename, ios::binary | ios::ate);
+        long long remaining = in ? static_cast<long long>(in.tellg()) : 0;
+        in.seekg(0);
+        string temp_filename = filename + ".tmp";
+        ofstream out(temp_filename, ios::binary | ios::trunc);
+        write_header(out);
+
+        vector<bool> kept(done.size(), false);
+        char magic[4];
+        uint32_t version = 0;
+        uint8_t flag = 0;
+        in.read(magic, sizeof(magic));
+        in.read(reinterpret_cast<char*>(&version), sizeof(version));
+        in.read(reinterpret_cast<char*>(&flag), sizeof(flag));
+        remaining -= sizeof(magic) + sizeof(version) + sizeof(flag);
+        if (in && memcmp(magic, WITNESS_MAGIC, sizeof(magic)) == 0 && version == WITNESS_VERSION &&
+            flag == compressed_) {
+            WitnessBlockHeader header;
+            vector<char> payload;
+            while (remaining >= static_cast<long long>(sizeof(header)) &&
+                   in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+                remaining -= sizeof(header);
+                if (header.problem_index < 0 || header.problem_index >= static_cast<int32_t>(done.size()) ||
+                    header.payload_size > static_cast<uint64_t>(remaining)) {
+                    break;
+                }
+                payload.resize(header.payload_size);
+                if (!in.read(payload.data(), payload.size())) break;
+                remaining -= payload.size();
+                if (!done[header.problem_index] || kept[header.problem_index]) continue;
+                out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                out.write(payload.data(), payload.size());
+                kept[header.problem_index] = true;
+            }
+        }
+        in.close();
+        out.close();
+        rename(temp_filename.c_str(), filename.c_str());
+        for (size_t i = 0; i < done.size(); ++i) {
+            if (done[i] && !kept[i]) done[i] = false;
+        }
+    }
+
+    void write_loop() {
+        unique_lock<mutex> lock(queue_mutex_);
+        while (true) {
+            ready_.wait(lock, [this] { return closing_ || !blocks_.empty(); });
+            if (blocks_.empty()) break;
+            deque<pair<vector<char>, function<void()>>> pending;
+            pending.swap(blocks_);
+            lock.unlock();
+            for (const auto& block : pending) file_.write(block.first.data(), block.first.size());
+            file_.flush();
+            for (const auto& block : pending) block.second();
+            lock.lock();
+        }
+    }
+
+    ofstream file_;
+    bool compressed_;
+    uint64_t max_solutions_;
+    mutex queue_mutex_;
+    condition_variable ready_;
+    deque<pair<vector<char>, function<void()>>> blocks_;
+    bool closing_ = false;
+    thread writer_;
+};
+
+// Перечисляет все непустые подмножества с нужной суммой по возрастанию маски и
+// собирает их в блок для WitnessSink (block). Суммы младших LOW бит сортируются вместе с
+// маской, поэтому для каждой старшей части совпадения находятся двоичным поиском
+// и уже идут по возрастанию. В блок попадает не больше max_solutions масок,
+// но считаются все решения. Работает для n ≤ WITNESS_MAX_N.
+tuple<double, double, int> enumerate_solutions(const vector<long long>& items, long long target_weight,
+                                               int problem_index, const WitnessSink& sink, vector<char>& block) {
+    int n = items.size() - 1;
+    vector<long long> weights(items.begin(), items.end() - 1);
+    int low_bits = n / 2;
+
+    double first_solution_time = 0.0;
+    uint64_t solutions_count = 0, stored_count = 0;
+    auto start_time = high_resolution_clock::now();
+
+    SumTable low_sums = subset_sums(weights, 0, low_bits);
+    SumTable high_sums = subset_sums(weights, low_bits, n);
+    vector<pair<long long, uint64_t>> low(low_sums.size());
+    for (size_t mask = 0; mask < low_sums.size(); ++mask) low[mask] = {low_sums[mask], mask};
+    sort(low.begin(), low.end());
+
+    vector<char> payload;
+    uint64_t previous = 0;
+    auto emit = [&](uint64_t mask) {
+        if (sink.compressed()) {
+            uint64_t delta = mask - previous;
+            previous = mask;
+            do {
+                uint8_t byte = delta & 0x7F;
+                delta >>= 7;
+                payload.push_back(static_cast<char>(byte | (delta ? 0x80 : 0)));
+            } while (delta);
+        } else {
+            for (int b = 0; b < (n + 7) / 8; ++b) payload.push_back(static_cast<char>(mask >> (8 * b)));
+        }
+    };
+
+    for (uint64_t high = 0; high < high_sums.size(); ++high) {
+        long long need = target_weight - high_sums[high];
+        auto it = lower_bound(low.begin(), low.end(), make_pair(need, uint64_t(0)));
+        for (; it != low.end() && it->first == need; ++it) {
+            uint64_t mask = (high << low_bits) | it->second;
+            if (mask == 0) continue;
+            if (solutions_count++ == 0) {
+                first_solution_time = duration<double>(high_resolution_clock::now() - start_time).count();
+            }
+            if (stored_count < sink.max_solutions()) {
+                emit(mask);
+                stored_count++;
+            }
+        }
+    }
+
+    WitnessBlockHeader header = {problem_index, static_cast<uint8_t>(n), solutions_count, stored_count, payload.size()};
+    block.assign(reinterpret_cast<const char*>(&header), reinterpret_cast<const char*>(&header) + sizeof(header));
+    block.insert(block.end(), payload.begin(), payload.end());
+
+    double all_solutions_time = duration<double>(high_resolution_clock::now() - start_time).count();
+    return make_tuple(first_solution_time, all_solutions_time, static_cast<int>(solutions_count));
+}
+
+// Номера файлов, результаты которых записал текущий запуск. Без --resume список
+// очищается в начале запуска, поэтому при продолжении пропускаются только файлы,
+// законченные этим запуском, а не CSV, оставшиеся от прежних.
+const string RUN_MANIFEST = "knapsack_solutions.run";
+
+set<int> load_run_manifest() {
+    set<int> completed;
+    ifstream file(RUN_MANIFEST);
+    int file_number;
+    while (file >> file_number) completed.insert(file_number);
+    return completed;
+}
+
+void mark_file_completed(int file_number) {
+    ofstream file(RUN_MANIFEST, ios::app);
+    file << file_number << "\n";
+}
+
+void worker(queue<int>& problem_indices, const vector<vector<long long>>& problems, vector<Result>& results,
+            ofstream& checkpoint, const vector<Engine>& engines, WitnessSink* sink, FileStats& stats,
+            unsigned int thread_index, long long modulus) {
+    engine_modulus = modulus;
+    if (pin_threads) pin_to_core(thread_index);
+    unique_ptr<HugePageArena> arena;
+    if (huge_pages != HugePages::None) {
+        arena = make_unique<HugePageArena>(huge_pages);
+        current_arena = arena.get();
+    }
+
+    while (true) {
+        int problem_index;
+        {
+            lock_guard<mutex> lock(mtx);
+            if (problem_indices.empty()) break;
+            problem_index = problem_indices.front();
+            problem_indices.pop();
+        }
+
+        if (arena) arena->reset();
+        last_approximation = Approximation();
+        long long target_weight = problems[problem_index].back();
+        vector<char> block;
+        bool enumerated = sink && static_cast<int>(problems[problem_index].size()) - 1 <= WITNESS_MAX_N;
+        auto [first_time, all_time, solution_count] =
+            enumerated ? enumerate_solutions(problems[problem_index], target_weight, problem_index, *sink, block)
+                       : engines[problem_index](problems[problem_index], target_weight);
+        stats.add({problem_index + 1, first_time, all_time, solution_count});
+        Result result = {problem_index + 1, first_time, all_time, solution_count, last_approximation.valid,
+                         last_approximation.best_sum, last_approximation.mask};
+
+        {
+            lock_guard<mutex> lock(mtx);
+            results[problem_index] = result;
+            if (!enumerated) append_checkpoint(checkpoint, problem_index, result);
+            cout << "Задача " << (problem_index + 1) << " решена: найдено " << solution_count << " решений" << endl;
+        }
+        // С --enumerate задача попадает в контрольную точку, только когда её блок записан.
+        if (enumerated) {
+            sink->submit(move(block), [&checkpoint, problem_index, result] {
+                lock_guard<mutex> lock(mtx);
+                append_checkpoint(checkpoint, problem_index, result);
+            });
+        }
+    }
+    current_arena = nullptr;
+}
+
+void save_results(const vector<Result>& results, const string& filename) {
+    ofstream file(filename);
+    if (file.is_open()) {
+        file << "Problem Number,First Solution Time (s),All Solutions Time (s),Number of Solutions\n";
+        for (const auto& result : results) {
+            file << result.problem_number << ","
+                 << (result.first_solution_time > 0 ? to_string(result.first_solution_time) : "N/A") << ","
+                 << result.all_solutions_time << ","
+                 << result.solutions_count << "\n";
+        }
+        file.close();
+    } else {
+        cerr << "Не удалось открыть файл: " << filename << endl;
+    }
+}
+
+// Задача о рюкзаке с ценностями (--value): строка файла value_knapsack_problems_N.csv —
+// n весов, n ценностей и вместимость. Ищется наибольшая суммарная ценность
+// подмножества, вес которого не превышает вместимости.
+struct ValueProblem {
+    vector<long long> weights;
+    vector<long long> values;
+    long long capacity;
+};
+
+ValueProblem parse_value_problem(const vector<long long>& row) {
+    size_t n = (row.size() - 1) / 2;
+    return {vector<long long>(row.begin(), row.begin() + n), vector<long long>(row.begin() + n, row.begin() + 2 * n),
+            row.back()};
+}
+
+// Наибольшая вместимость для динамики: два массива по 16 МБ на поток.
+const long long DP_MAX_CAPACITY = 1LL << 21;
+
+// cur[c] = max(prev[c], prev[c - weight] + value) для c ≥ weight.
+void relax_item(const vector<long long>& prev, vector<long long>& cur, long long weight, long long value) {
+    size_t capacity = prev.size() - 1;
+    size_t c = 0;
+    for (; c < static_cast<size_t>(weight) && c <= capacity; ++c) cur[c] = prev[c];
+#ifdef __AVX2__
+    __m256i add = _mm256_set1_epi64x(value);
+    for (; c + 4 <= capacity + 1; c += 4) {
+        __m256i skip = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&prev[c]));
+        __m256i take = _mm256_add_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(&prev[c - weight])), add);
+        __m256i better = _mm256_cmpgt_epi64(take, skip);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(&cur[c]), _mm256_blendv_epi8(skip, take, better));
+    }
+#endif
+    for (; c <= capacity; ++c) cur[c] = max(prev[c], prev[c - weight] + value);
+}
+
+// Динамика по вместимости с двумя строками (предыдущий и текущий предмет): каждая
+// строка проходится подряд, а без зависимости внутри строки цикл векторизуется.
+// Предметы с отрицательной ценностью или не помещающиеся целиком не берутся.
+long long value_knapsack_dp(const ValueProblem& problem) {
+    vector<long long> prev(problem.capacity + 1, 0), cur(problem.capacity + 1, 0);
+    for (size_t i = 0; i < problem.weights.size(); ++i) {
+        if (problem.values[i] <= 0 || problem.weights[i] > problem.capacity) continue;
+        relax_item(prev, cur, max(0LL, problem.weights[i]), problem.values[i]);
+        swap(prev, cur);
+    }
+    return prev[problem.capacity];
+}
+
+// Перебор в порядке кода Грея для вместимостей, слишком больших для динамики.
+long long value_knapsack_bruteforce(const ValueProblem& problem) {
+    int n = problem.weights.size();
+    long long weight = 0, value = 0, best = 0;
+    for (uint64_t step = 1; step < (uint64_t(1) << n); ++step) {
+        int bit = __builtin_ctzll(step);
+        long long sign = ((step ^ (step >> 1)) >> bit) & 1 ? 1 : -1;
+        weight += sign * problem.weights[bit];
+        value += sign * problem.values[bit];
+        if (weight <= problem.capacity && value > best) best = value;
+    }
+    return best;
+}
+
+struct ValueResult {
+    int problem_number;
+    double time;
+    long long best_value;
+    string method;
+};
+
+void value_worker(queue<int>& problem_indices, const vector<vector<long long>>& rows, vector<ValueResult>& results) {
+    while (true) {
+        int problem_index;
+        {
+            lock_guard<mutex> lock(mtx);
+            if (problem_indices.empty()) break;
+            problem_index = problem_indices.front();
+            problem_indices.pop();
+        }
+
+        ValueProblem problem = parse_value_problem(rows[problem_index]);
+        bool use_dp = problem.capacity >= 0 && problem.capacity <= DP_MAX_CAPACITY;
+        auto start_time = high_resolution_clock::now();
+        long long best = use_dp ? value_knapsack_dp(problem) : value_knapsack_bruteforce(problem);
+        double time = duration<double>(high_resolution_clock::now() - start_time).count();
+
+        lock_guard<mutex> lock(mtx);
+        results[problem_index] = {problem_index + 1, time, best, use_dp ? "dp" : "bruteforce"};
+        cout << "Задача " << (problem_index + 1) << " решена: наибольшая ценность " << best << endl;
+    }
+}
+
+void process_value_files() {
+    for (int i = 1; i <= 4; ++i) {
+        string input_filename = "value_knapsack_problems_" + to_string(i) + ".csv";
+        string output_filename = "value_knapsack_solutions_" + to_string(i) + ".csv";
+        if (!ifstream(input_filename).good()) continue;
+
+        vector<vector<long long>> rows = load_problems(input_filename);
+        vector<ValueResult> results(rows.size());
+        queue<int> problem_indices;
+        for (size_t j = 0; j < rows.size(); ++j) problem_indices.push(j);
+
+        unsigned int num_threads = thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 4;
+        cout << "Обрабатываем " << input_filename << " с использованием " << num_threads << " потоков." << endl;
+
+        vector<thread> threads;
+        for (unsigned int j = 0; j < num_threads; ++j) {
+            threads.emplace_back(value_worker, ref(problem_indices), cref(rows), ref(results));
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+
+        ofstream file(output_filename);
+        file << "Problem Number,Time (s),Best Value,Method\n";
+        for (const auto& result : results) {
+            file << result.problem_number << "," << result.time << "," << result.best_value << "," << result.method << "\n";
+        }
+        cout << "Результаты сохранены в " << output_filename << endl;
+    }
+}
+
+// Режим демона (--daemon=ПУТЬ): пул потоков создаётся один раз, а задачи приходят
+// через Unix-сокет. Каждый кадр — длина (uint32) и тело. Тело запроса: DaemonRequest,
+// затем problem_count * (n + 1) чисел int64 (веса и цель). Ответ на каждую задачу
+// отправляется сразу после решения кадром DaemonResponse; кадр с problem_index = -1
+// завершает пакет. На одном соединении можно отправлять пакеты подряд. На
+// некорректный запрос приходит кадр с problem_index = -2; если испорчена сама длина
+// кадра, соединение после него закрывается.
+const char DAEMON_MAGIC[4] = {'K', 'S', 'R', 'Q'};
+// Пределы запроса: число весов (маски подмножеств 64-битные) и длина кадра.
+const uint32_t DAEMON_MAX_N = 64;
+const uint32_t DAEMON_MAX_FRAME = 64 << 20;
+
+#pragma pack(push, 1)
+struct DaemonRequest {
+    char magic[4];
+    uint32_t problem_count;
+    uint32_t n;
+    uint8_t mode;       // SolveMode для --engine=auto
+    char engine[16];    // имя метода, дополненное нулями
+};
+
+struct DaemonResponse {
+    int32_t problem_index;
+    double first_solution_time;
+    double all_solutions_time;
+    int32_t solutions_count;
+};
+#pragma pack(pop)
+
+// Пул потоков, живущий всё время работы демона: кэши потоков (например, слои
+// метода bitset) сохраняются между запросами.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned int size) {
+        for (unsigned int i = 0; i < size; ++i) workers_.emplace_back([this] { run(); });
+    }
+
+    ~ThreadPool() {
+        {
+            lock_guard<mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        ready_.notify_all();
+        for (auto& t : workers_) t.join();
+    }
+
+    void submit(function<void()> task) {
+        {
+            lock_guard<mutex> lock(mutex_);
+            tasks_.push(move(task));
+        }
+        ready_.notify_one();
+    }
+
+private:
+    void run() {
+        while (true) {
+            function<void()> task;
+            {
+                unique_lock<mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;
+                task = move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+        }
+    }
+
+    vector<thread> workers_;
+    queue<function<void()>> tasks_;
+    mutex mutex_;
+    condition_variable ready_;
+    bool stopping_ = false;
+};
+
+bool read_exact(int fd, void* data, size_t size) {
+    char* p = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = read(fd, p, size);
+        if (got <= 0) return false;
+        p += got;
+        size -= got;
+    }
+    return true;
+}
+
+bool write_frame(int fd, const void* data, uint32_t size) {
+    char frame[sizeof(uint32_t) + sizeof(DaemonResponse)];
+    memcpy(frame, &size, sizeof(size));
+    memcpy(frame + sizeof(size), data, size);
+    size_t total = sizeof(size) + size, sent = 0;
+    while (sent < total) {
+        ssize_t n = send(fd, frame + sent, total - sent, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        sent += n;
+    }
+    return true;
+}
+
+// Обслуживает одно соединение: разбирает пакеты, раздаёт задачи пулу и ждёт, пока
+// все ответы пакета будут отправлены. Буфер запроса переиспользуется между пакетами.
+void serve_connection(int fd, ThreadPool& pool) {
+    vector<char> buffer;
+    mutex write_mutex;
+    const DaemonResponse error = {-2, 0.0, 0.0, 0};
+    while (true) {
+        uint32_t size = 0;
+        if (!read_exact(fd, &size, sizeof(size))) break;
+        if (size < sizeof(DaemonRequest) || size > DAEMON_MAX_FRAME) {
+            cerr << "Некорректная длина кадра демону: " << size << endl;
+            write_frame(fd, &error, sizeof(error));
+            break;
+        }
+        buffer.resize(size);
+        if (!read_exact(fd, buffer.data(), size)) break;
+
+        DaemonRequest request;
+        memcpy(&request, buffer.data(), sizeof(request));
+        request.engine[sizeof(request.engine) - 1] = '\0';
+        string engine_name = request.engine;
+        Engine engine = engine_name == "auto" ? nullptr : select_engine(engine_name);
+        // В протоколе нет модуля, поэтому метод modular демону недоступен.
+        bool valid = memcmp(request.magic, DAEMON_MAGIC, sizeof(DAEMON_MAGIC)) == 0 && request.mode <= 2 &&
+                     request.n >= 1 && request.n <= DAEMON_MAX_N && (engine != nullptr || engine_name == "auto") &&
+                     engine_name != "modular";
+        if (valid) {
+            size_t values = size_t(request.problem_count) * (size_t(request.n) + 1);
+            valid = (size - sizeof(request)) / sizeof(int64_t) == values &&
+                    (size - sizeof(request)) % sizeof(int64_t) == 0;
+        }
+        if (!valid) {
+            cerr << "Некорректный запрос демону" << endl;
+            if (!write_frame(fd, &error, sizeof(error))) break;
+            continue;
+        }
+
+        vector<vector<long long>> problems(request.problem_count, vector<long long>(request.n + 1));
+        const char* data = buffer.data() + sizeof(request);
+        for (auto& problem : problems) {
+            memcpy(problem.data(), data, problem.size() * sizeof(int64_t));
+            data += problem.size() * sizeof(int64_t);
+        }
+
+        mutex done_mutex;
+        condition_variable done;
+        size_t remaining = problems.size();
+        SolveMode mode = static_cast<SolveMode>(request.mode);
+        for (size_t i = 0; i < problems.size(); ++i) {
+            pool.submit([&, i] {
+                Engine chosen = engine ? engine : plan_problem(profile_problem(problems[i], 0), mode).engine;
+                auto [first_time, all_time, solution_count] = chosen(problems[i], problems[i].back());
+                DaemonResponse response = {static_cast<int32_t>(i), first_time, all_time, solution_count};
+                {
+                    lock_guard<mutex> lock(write_mutex);
+                    write_frame(fd, &response, sizeof(response));
+                }
+                lock_guard<mutex> lock(done_mutex);
+                if (--remaining == 0) done.notify_one();
+            });
+        }
+        unique_lock<mutex> lock(done_mutex);
+        done.wait(lock, [&] { return remaining == 0; });
+        lock.unlock();
+
+        DaemonResponse end = {-1, 0.0, 0.0, 0};
+        if (!write_frame(fd, &end, sizeof(end))) break;
+    }
+    close(fd);
+}
+
+int run_daemon(const string& socket_path) {
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (server < 0 || socket_path.size() >= sizeof(address.sun_path)) {
+        cerr << "Не удалось создать сокет " << socket_path << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path.c_str());
+    unlink(socket_path.c_str());
+    if (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(server, 16) < 0) {
+        cerr << "Не удалось открыть сокет " << socket_path << endl;
+        return 1;
+    }
+
+    unsigned int num_threads = thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+    ThreadPool pool(num_threads);
+    cout << "Демон слушает " << socket_path << " (" << num_threads << " потоков)" << endl;
+
+    while (true) {
+        int client = accept(server, nullptr, nullptr);
+        if (client < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            // Нехватка дескрипторов или памяти проходит, когда закроются соединения:
+            // ждём, а не крутимся в цикле. Остальные ошибки не исправятся сами.
+            if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+                cerr << "accept: " << strerror(errno) << ", повтор через 100 мс" << endl;
+                this_thread::sleep_for(chrono::milliseconds(100));
+                continue;
+            }
+            cerr << "accept: " << strerror(errno) << endl;
+            close(server);
+            return 1;
+        }
+        thread(serve_connection, client, ref(pool)).detach();
+    }
+}
+
+// C-интерфейс для Python (knapsack.py через ctypes), при сборке в разделяемую библиотеку:
+//   g++ -std=c++17 -O2 -shared -fPIC -pthread all_sol.cpp -o libknapsack.so
+// Веса — непрерывная матрица count x n, цели — массив count; результаты пишутся в
+// массивы вызывающего, поэтому массивы NumPy передаются без копирования. ctypes
+// отпускает GIL на время вызова. Метод "auto" выбирается планировщиком (режим count).
+// modulus > 0 задаёт engine_modulus потокам этого вызова. Возвращает 0 или -1 для
+// неизвестного метода, modular без модуля, n < 1 или count < 0.
+extern "C" int knapsack_solve(const char* engine_name, const int64_t* weights, const int64_t* targets,
+                              int64_t count, int32_t n, int64_t modulus, int32_t threads,
+                              double* first_times, double* all_times, int32_t* counts) {
+    string name = engine_name;
+    Engine engine = name == "auto" ? nullptr : select_engine(name);
+    if (engine == nullptr && name != "auto") return -1;
+    if ((name == "modular" && modulus <= 0) || n < 1 || count < 0) return -1;
+
+    atomic<int64_t> next{0};
+    auto run = [&] {
+        long long saved_modulus = engine_modulus;
+        engine_modulus = modulus;
+        vector<long long> problem(n + 1);
+        for (int64_t i = next++; i < count; i = next++) {
+            copy(weights + i * n, weights + (i + 1) * n, problem.begin());
+            problem[n] = targets[i];
+            Engine chosen = engine ? engine : plan_problem(profile_problem(problem, modulus), SolveMode::Count).engine;
+            auto [first_time, all_time, solution_count] = chosen(problem, targets[i]);
+            first_times[i] = first_time;
+            all_times[i] = all_time;
+            counts[i] = solution_count;
+        }
+        engine_modulus = saved_modulus;
+    };
+
+    unsigned int num_threads = threads > 0 ? threads : thread::hardware_concurrency();
+    vector<thread> pool;
+    for (unsigned int t = 1; t < max(1u, num_threads); ++t) pool.emplace_back(run);
+    run();
+    for (auto& t : pool) t.join();
+    return 0;
+}
+
+// Ответы приближённого метода: цель, лучшая сумма, её доля от цели и маска подмножества
+// (бит i — вес i).
+void save_approximations(const vector<Result>& results, const vector<vector<long long>>& problems,
+                         const string& filename) {
+    ofstream file(filename);
+    file << "Problem Number,Target,Best Sum,Ratio,Subset Mask\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].approximated) continue;
+        long long target_weight = problems[i].back();
+        ostringstream mask;
+        mask << "0x" << hex << results[i].best_mask;
+        file << results[i].problem_number << "," << target_weight << "," << results[i].best_sum << ","
+             << (target_weight != 0 ? double(results[i].best_sum) / target_weight : 1.0) << "," << mask.str() << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool resume = false;
+    bool modular = false;
+    string engine_name = "bruteforce";
+    string mode_name = "count";
+    bool enumerate = false;
+    bool compress = false;
+    uint64_t max_solutions = UINT64_MAX;
+    string daemon_path;
+    bool summary_only = false;
+    for (int a = 1; a < argc; ++a) {
+        string arg = argv[a];
+        if (arg == "--resume") resume = true;
+        else if (arg.rfind("--engine=", 0) == 0) engine_name = arg.substr(9);
+        else if (arg.rfind("--engine-threads=", 0) == 0) engine_threads = max(1, stoi(arg.substr(17)));
+        else if (arg.rfind("--epsilon=", 0) == 0) approx_epsilon = stod(arg.substr(10));
+        else if (arg.rfind("--mode=", 0) == 0) mode_name = arg.substr(7);
+        else if (arg == "--modular") modular = true;
+        else if (arg == "--enumerate") enumerate = true;
+        else if (arg == "--compress") compress = true;
+        else if (arg.rfind("--max-solutions=", 0) == 0) max_solutions = stoull(arg.substr(16));
+        else if (arg.rfind("--daemon=", 0) == 0) daemon_path = arg.substr(9);
+        else if (arg == "--summary-only") summary_only = true;
+        else if (arg == "--pin") pin_threads = true;
+        else if (arg == "--huge-pages=thp") huge_pages = HugePages::Transparent;
+        else if (arg == "--huge-pages=explicit") huge_pages = HugePages::Explicit;
+        else if (arg == "--value") {
+            process_value_files();
+            return 0;
+        }
+    }
+
+    if (!daemon_path.empty()) return run_daemon(daemon_path);
+
+    // --engine=auto: метод выбирается для каждой задачи планировщиком.
+    bool planned = engine_name == "auto";
+    Engine engine = planned ? nullptr : select_engine(engine_name);
+    if (!planned && engine == nullptr) {
+        cerr << "Неизвестный метод: " << engine_name << endl;
+        return 1;
+    }
+    if (enumerate && modular) {
+        cerr << "Перечисление решений не поддерживает суммы по модулю" << endl;
+        return 1;
+    }
+    if (modular && !planned && engine_name != "modular" && engine_name != "lll") {
+        cerr << "Метод " << engine_name << " не поддерживает суммы по модулю" << endl;
+        return 1;
+    }
+    if (!modular && engine_name == "modular") {
+        cerr << "Метод modular работает только с --modular" << endl;
+        return 1;
+    }
+
+    SolveMode mode;
+    if (mode_name == "count") mode = SolveMode::Count;
+    else if (mode_name == "exists") mode = SolveMode::Exists;
+    else if (mode_name == "best") mode = SolveMode::BestEffort;
+    else {
+        cerr << "Неизвестный режим: " << mode_name << endl;
+        return 1;
+    }
+    if (!planned && engine_mode(engine_name) > mode) {
+        cerr << "Метод " << engine_name << " не считает все решения и требует --mode="
+             << (engine_mode(engine_name) == SolveMode::Exists ? "exists" : "best") << endl;
+        return 1;
+    }
+
+    // Файлы 1-4 сгенерированы с теми же A_MAX, что и 5-8.
+    vector<FileSummary> summaries;
+    if (!resume) ofstream(RUN_MANIFEST, ios::trunc);
+    set<int> completed = load_run_manifest();
+    int first_file = modular ? 5 : 1;
+    for (int i = first_file; i < first_file + 4; ++i) {
+        engine_modulus = modular ? A_MAX_VALUES[i - 5] : 0;
+        string input_filename = "knapsack_problems_" + to_string(i) + ".csv";
+        string output_filename = "knapsack_solutions_" + to_string(i) + ".csv";
+        string checkpoint_filename = "knapsack_solutions_" + to_string(i) + ".ckpt";
+
+        if (resume && completed.count(i) && !ifstream(checkpoint_filename).good()) {
+            cout << "Пропускаем " << input_filename << ": результаты уже сохранены" << endl;
+            continue;
+        }
+
+        vector<vector<long long>> problems = load_problems(input_filename);
+        vector<Result> results(problems.size());
+
+        vector<bool> done(problems.size(), false);
+        if (resume) done = load_checkpoint(checkpoint_filename, results);
+        size_t resumed = count(done.begin(), done.end(), true);
+
+        // Файл решений открывается до очереди задач: при продолжении задачи, чей блок
+        // не сохранился целиком, снова становятся нерешёнными.
+        unique_ptr<WitnessSink> sink;
+        if (enumerate) {
+            string witness_filename = "knapsack_witnesses_" + to_string(i) + ".bin";
+            sink = make_unique<WitnessSink>(witness_filename, compress, max_solutions, resumed > 0 ? &done : nullptr);
+            resumed = count(done.begin(), done.end(), true);
+            cout << "Решения записываются в " << witness_filename << endl;
+        }
+
+        ofstream checkpoint;
+        if (resumed > 0) {
+            checkpoint.open(checkpoint_filename, ios::binary | ios::app);
+            cout << "Продолжаем " << input_filename << ": уже решено " << resumed << " задач" << endl;
+        } else {
+            checkpoint.open(checkpoint_filename, ios::binary | ios::trunc);
+            write_checkpoint_header(checkpoint, problems.size());
+        }
+
+        queue<int> problem_indices;
+        for (size_t j = 0; j < problems.size(); ++j) {
+            if (!done[j]) problem_indices.push(j);
+            if (!done[j] && enumerate && static_cast<int>(problems[j].size()) - 1 > WITNESS_MAX_N) {
+                cerr << "Задача " << (j + 1) << ": n = " << problems[j].size() - 1 << " больше " << WITNESS_MAX_N
+                     << ", решения не перечисляются, используется метод " << engine_name << endl;
+            }
+        }
+
+        vector<Engine> engines(problems.size(), engine);
+        if (planned) {
+            double predicted_total = 0.0;
+            for (size_t j = 0; j < problems.size(); ++j) {
+                if (done[j]) continue;
+                ProblemProfile profile = profile_problem(problems[j], engine_modulus);
+                Plan plan = plan_problem(profile, mode);
+                engines[j] = plan.engine;
+                predicted_total += plan.predicted_cost;
+                cout << "Задача " << (j + 1) << ": метод " << plan.engine_name << ", прогноз " << plan.predicted_cost
+                     << " с (n = " << profile.n << ", плотность " << profile.density << ", сумма весов "
+                     << profile.total << (profile.modulus > 0 ? ", модуль " + to_string(profile.modulus) : "")
+                     << ")" << endl;
+            }
+            cout << "Прогноз для " << input_filename << ": " << predicted_total << " с процессорного времени" << endl;
+        }
+
+        unsigned int num_threads = thread::hardware_concurrency();
+        if (num_threads == 0) num_threads = 4;
+        num_threads = max(1u, num_threads / engine_threads);
+        cout << "Обрабатываем " << input_filename << " с использованием " << num_threads << " потоков." << endl;
+
+        vector<FileStats> thread_stats(num_threads);
+        vector<thread> threads;
+        for (unsigned int j = 0; j < num_threads; ++j) {
+            threads.emplace_back(worker, ref(problem_indices), cref(problems), ref(results), ref(checkpoint),
+                                 cref(engines), sink.get(), ref(thread_stats[j]), j, engine_modulus);
+        }
+
+        for (auto& t : threads) {
+            t.join();
+        }
+        sink.reset();
+
+        summaries.push_back({input_filename, A_MAX_VALUES[(i - 1) % 4], FileStats()});
+        for (size_t j = 0; j < problems.size(); ++j) {
+            if (done[j]) summaries.back().stats.add(results[j]);
+        }
+        for (const auto& stats : thread_stats) summaries.back().stats.merge(stats);
+
+        // --summary-only: построчные результаты не пишутся, остаётся только сводка ниже.
+        if (!summary_only) {
+            save_results(results, output_filename);
+            if (any_of(results.begin(), results.end(), [](const Result& r) { return r.approximated; })) {
+                save_approximations(results, problems, "knapsack_approximations_" + to_string(i) + ".csv");
+            }
+            mark_file_completed(i);
+            cout << "Результаты сохранены в " << output_filename << endl;
+        }
+        // Контрольная точка удаляется только после записи CSV: если процесс прервётся
+        // раньше, --resume восстановит результаты из неё.
+        checkpoint.close();
+        remove(checkpoint_filename.c_str());
     }
 
+    print_summary(summaries);
     return 0;
 }
 
@@ -9,7 +9,10 @@
 #include <numeric>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
 #include <queue>
+#include <atomic>
+#include <memory>
 
 using namespace std;
 
@@ -91,25 +94,152 @@ struct Result {
 };
 
 
-void worker(queue<int>& problem_indices, const vector<vector<long long>>& problems, vector<Result>& results) {
-    while (true) {
-        int problem_index;
-        {
-            lock_guard<mutex> lock(mtx);
-            if (problem_indices.empty()) break;
-            problem_index = problem_indices.front();
-            problem_indices.pop();
+// Bounded multi-producer/multi-consumer ring buffer without locks (Vyukov's scheme):
+// every slot carries a sequence number that tells producers and consumers whether
+// it is free or filled for their turn. try_push/try_pop fail instead of blocking;
+// push/pop go through the same lock-free path and only when it fails sleep on a
+// condition variable. The other side takes the mutex to notify only if someone
+// sleeps, so the uncontended path stays lock-free.
+template <typename T>
+class BoundedQueue {
+public:
+    explicit BoundedQueue(size_t capacity) : slots_(capacity), mask_(capacity - 1) {
+        for (size_t i = 0; i < capacity; ++i) slots_[i].sequence.store(i, memory_order_relaxed);
+    }
+
+    bool try_push(const T& value) {
+        size_t pos = tail_.load(memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            if (sequence == pos) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(pos + 1, memory_order_release);
+                    return true;
+                }
+            } else if (sequence < pos) {
+                return false;
+            } else {
+                pos = tail_.load(memory_order_relaxed);
+            }
         }
+    }
 
-        long long target_weight = problems[problem_index].back();
-        auto [first_time, all_time, solution_count] = solve_knapsack_bruteforce(problems[problem_index], target_weight);
+    bool try_pop(T& value) {
+        size_t pos = head_.load(memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[pos & mask_];
+            size_t sequence = slot.sequence.load(memory_order_acquire);
+            if (sequence == pos + 1) {
+                if (head_.compare_exchange_weak(pos, pos + 1, memory_order_relaxed)) {
+                    value = slot.value;
+                    slot.sequence.store(pos + mask_ + 1, memory_order_release);
+                    return true;
+                }
+            } else if (sequence < pos + 1) {
+                return false;
+            } else {
+                pos = head_.load(memory_order_relaxed);
+            }
+        }
+    }
 
-        lock_guard<mutex> lock(mtx);
-        results[problem_index] = {problem_index + 1, first_time, all_time, solution_count};
-        cout << "Problem " << (problem_index + 1) << "/" << problems.size() << " solved: " << solution_count << " solutions found (File: " << problem_indices.size() << " remaining)" << endl;
+    void push(const T& value) {
+        if (!try_push(value)) {
+            unique_lock<mutex> lock(wait_mutex_);
+            producers_waiting_.fetch_add(1);
+            atomic_thread_fence(memory_order_seq_cst);
+            not_full_.wait(lock, [&] { return try_push(value); });
+            producers_waiting_.fetch_sub(1);
+        }
+        atomic_thread_fence(memory_order_seq_cst);
+        if (consumers_waiting_.load() > 0) {
+            lock_guard<mutex> lock(wait_mutex_);
+            not_empty_.notify_one();
+        }
     }
-}
 
+    // Blocks until a value arrives; returns false once the queue is closed and drained.
+    bool pop(T& value) {
+        if (!try_pop(value)) {
+            unique_lock<mutex> lock(wait_mutex_);
+            consumers_waiting_.fetch_add(1);
+            atomic_thread_fence(memory_order_seq_cst);
+            bool popped = false;
+            not_empty_.wait(lock, [&] { return (popped = try_pop(value)) || closed_; });
+            consumers_waiting_.fetch_sub(1);
+            if (!popped) return false;
+        }
+        atomic_thread_fence(memory_order_seq_cst);
+        if (producers_waiting_.load() > 0) {
+            lock_guard<mutex> lock(wait_mutex_);
+            not_full_.notify_one();
+        }
+        return true;
+    }
+
+    // No more pushes will follow: wakes every consumer so that they drain and return.
+    void close() {
+        lock_guard<mutex> lock(wait_mutex_);
+        closed_ = true;
+        not_empty_.notify_all();
+    }
+
+private:
+    struct Slot {
+        atomic<size_t> sequence;
+        T value;
+    };
+    vector<Slot> slots_;
+    size_t mask_;
+    alignas(64) atomic<size_t> head_{0};
+    alignas(64) atomic<size_t> tail_{0};
+
+    mutex wait_mutex_;
+    condition_variable not_empty_;
+    condition_variable not_full_;
+    atomic<int> consumers_waiting_{0};
+    atomic<int> producers_waiting_{0};
+    bool closed_ = false;
+};
+
+// One input file travelling through the pipeline: loaded by the reader, filled in by
+// the solvers, and handed to the writer when its last problem is solved.
+struct FileBatch {
+    string input_file;
+    string output_file;
+    vector<vector<long long>> problems;
+    vector<Result> results;
+    atomic<size_t> remaining{0};
+};
+
+struct Task {
+    FileBatch* batch;
+    size_t problem_index;
+};
+
+// Queue capacities (powers of two): how far the reader may run ahead of the solvers,
+// and how many finished files may wait for the writer.
+const size_t TASK_QUEUE_CAPACITY = 1024;
+const size_t WRITE_QUEUE_CAPACITY = 8;
+
+// Runs until the reader closes the task queue and it is drained.
+void solver(BoundedQueue<Task>& tasks, BoundedQueue<FileBatch*>& finished) {
+    Task task;
+    while (tasks.pop(task)) {
+        FileBatch& batch = *task.batch;
+        const vector<long long>& problem = batch.problems[task.problem_index];
+        auto [first_time, all_time, solution_count] = solve_knapsack_bruteforce(problem, problem.back());
+        batch.results[task.problem_index] = {static_cast<int>(task.problem_index) + 1, first_time, all_time, solution_count};
+        {
+            lock_guard<mutex> lock(mtx);
+            cout << "Problem " << (task.problem_index + 1) << "/" << batch.problems.size() << " of " << batch.input_file
+                 << " solved: " << solution_count << " solutions found" << endl;
+        }
+        if (batch.remaining.fetch_sub(1, memory_order_acq_rel) == 1) finished.push(&batch);
+    }
+}
 
 void save_results(const vector<Result>& results, const string& filename) {
     ofstream file(filename);
@@ -127,62 +257,79 @@ void save_results(const vector<Result>& results, const string& filename) {
     }
 }
 
+void print_results(const string& input_file, const vector<Result>& results) {
+    lock_guard<mutex> lock(mtx);
+    cout << "\nResults for " << input_file << ":" << endl;
+    cout << string(80, '-') << endl;
+    cout << left << setw(10) << "Problem" << setw(20) << "First Time (s)" << setw(20) << "All Time (s)" << setw(10) << "Solutions" << endl;
+    cout << string(80, '-') << endl;
+    for (const auto& result : results) {
+        cout << left << setw(10) << result.problem_number
+             << setw(20) << (result.first_solution_time > 0 ? to_string(result.first_solution_time).substr(0, 8) : "N/A")
+             << setw(20) << to_string(result.all_solutions_time).substr(0, 8)
+             << setw(10) << result.solutions_count << endl;
+    }
+    cout << string(80, '-') << endl;
+}
+
+// Reader, solver pool and writer run as one pipeline over all files: the next file is
+// parsed and the previous one written while the solvers keep working, so no core waits
+// at file boundaries. Files are written in the order they finish.
 int main() {
 
     const int num_files = 4;
-    vector<string> input_files = {"knapsack_problems_1.csv", "knapsack_problems_2.csv",
-                                 "knapsack_problems_3.csv"};
-    vector<string> output_files = {"knapsack_solutions_1.csv", "knapsack_solutions_2.csv",
-                                  "knapsack_solutions_3.csv"};
-
-
-    for (int file_idx = 0; file_idx < num_files; ++file_idx) {
-        cout << "\nProcessing " << input_files[file_idx] << "..." << endl;
-
-
-        vector<vector<long long>> problems = load_problems(input_files[file_idx]);
-
-
-        vector<Result> results(problems.size());
-
+    vector<unique_ptr<FileBatch>> batches;
+    for (int file_idx = 1; file_idx <= num_files; ++file_idx) {
+        batches.push_back(make_unique<FileBatch>());
+        batches.back()->input_file = "knapsack_problems_" + to_string(file_idx) + ".csv";
+        batches.back()->output_file = "knapsack_solutions_" + to_string(file_idx) + ".csv";
+    }
 
-        queue<int> problem_indices;
-        for (size_t i = 0; i < problems.size(); ++i) {
-            problem_indices.push(i);
+    BoundedQueue<Task> tasks(TASK_QUEUE_CAPACITY);
+    BoundedQueue<FileBatch*> finished(WRITE_QUEUE_CAPACITY);
+
+    thread reader([&] {
+        for (auto& batch : batches) {
+            batch->problems = load_problems(batch->input_file);
+            batch->results.resize(batch->problems.size());
+            batch->remaining = batch->problems.size();
+            {
+                lock_guard<mutex> lock(mtx);
+                cout << "\nLoaded " << batch->input_file << ": " << batch->problems.size() << " problems" << endl;
+            }
+            // Once the last task is pushed the writer may already be clearing the batch.
+            size_t count = batch->problems.size();
+            if (count == 0) finished.push(batch.get());
+            for (size_t i = 0; i < count; ++i) tasks.push({batch.get(), i});
         }
-
-
-        unsigned int num_threads = thread::hardware_concurrency();
-        if (num_threads == 0) num_threads = 4;
-        cout << "Using " << num_threads << " threads for this file." << endl;
-
-
-        vector<thread> threads;
-        for (unsigned int i = 0; i < num_threads; ++i) {
-            threads.emplace_back(worker, ref(problem_indices), cref(problems), ref(results));
+        tasks.close();
+    });
+
+    thread writer([&] {
+        for (int written = 0; written < num_files; ++written) {
+            FileBatch* batch = nullptr;
+            finished.pop(batch);
+            save_results(batch->results, batch->output_file);
+            print_results(batch->input_file, batch->results);
+            batch->problems.clear();
+            batch->problems.shrink_to_fit();
         }
+    });
 
+    unsigned int num_threads = thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+    cout << "Using " << num_threads << " solver threads." << endl;
 
-        for (auto& t : threads) {
-            t.join();
-        }
-
-
-        save_results(results, output_files[file_idx]);
-
+    vector<thread> threads;
+    for (unsigned int i = 0; i < num_threads; ++i) {
+        threads.emplace_back(solver, ref(tasks), ref(finished));
+    }
 
-        cout << "\nResults for " << input_files[file_idx] << ":" << endl;
-        cout << string(80, '-') << endl;
-        cout << left << setw(10) << "Problem" << setw(20) << "First Time (s)" << setw(20) << "All Time (s)" << setw(10) << "Solutions" << endl;
-        cout << string(80, '-') << endl;
-        for (const auto& result : results) {
-            cout << left << setw(10) << result.problem_number
-                 << setw(20) << (result.first_solution_time > 0 ? to_string(result.first_solution_time).substr(0, 8) : "N/A")
-                 << setw(20) << to_string(result.all_solutions_time).substr(0, 8)
-                 << setw(10) << result.solutions_count << endl;
-        }
-        cout << string(80, '-') << endl;
+    reader.join();
+    for (auto& t : threads) {
+        t.join();
     }
+    writer.join();
 
     cout << "\nAll files processed successfully." << endl;
     return 0;
@@ -0,0 +1,63 @@
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+# Сравнение размещения памяти в all_sol: закрепление потоков (--pin) и большие страницы
+# (--huge-pages=thp|explicit) на модульных задачах с n = 40, где встреча посередине
+# работает с двумя таблицами по 2^20 сумм и почти каждый доступ промахивается мимо TLB.
+# Запуск: python3 benchmark_memory.py ./all_sol [число задач на файл]
+# Если установлен perf, для каждого варианта выводятся и промахи dTLB.
+
+VARIANTS = [
+    [],
+    ["--pin"],
+    ["--huge-pages=thp"],
+    ["--pin", "--huge-pages=thp"],
+    ["--pin", "--huge-pages=explicit"],
+]
+
+
+def generate_problems(directory, count, length=40):
+    for i in range(5, 9):
+        with open(os.path.join(directory, f"knapsack_problems_{i}.csv"), "w") as f:
+            for _ in range(count):
+                weights = [random.randint(1, 2**30) for _ in range(length)]
+                target = sum(random.sample(weights, length // 2))
+                f.write(",".join(map(str, [*weights, target])) + "\n")
+
+def run_variant(binary, directory, flags):
+    command = [binary, "--modular", "--engine=modular", "--summary-only", *flags]
+    perf = shutil.which("perf")
+    if perf:
+        command = [perf, "stat", "-x", ",", "-e", "dTLB-loads,dTLB-load-misses", *command]
+    start = time.perf_counter()
+    result = subprocess.run(command, cwd=directory, capture_output=True, text=True)
+    elapsed = time.perf_counter() - start
+
+    tlb = {}
+    for line in result.stderr.splitlines():
+        fields = line.split(",")
+        if len(fields) > 2 and fields[2].startswith("dTLB") and fields[0].isdigit():
+            tlb[fields[2]] = int(fields[0])
+    return elapsed, tlb
+
+if __name__ == "__main__":
+    binary = os.path.abspath(sys.argv[1])
+    count = int(sys.argv[2]) if len(sys.argv) > 2 else 8
+    random.seed(1)
+
+    directory = tempfile.mkdtemp()
+    try:
+        generate_problems(directory, count)
+        print(f"{'Флаги':<36}{'Время (с)':>12}{'Задач/с':>12}{'Промахи dTLB':>16}")
+        for flags in VARIANTS:
+            elapsed, tlb = run_variant(binary, directory, flags)
+            misses = tlb.get("dTLB-load-misses")
+            print(f"{' '.join(flags) or '(без флагов)':<36}{elapsed:>12.3f}{4 * count / elapsed:>12.2f}"
+                  f"{misses if misses is not None else 'н/д':>16}")
+    finally:
+        shutil.rmtree(directory)
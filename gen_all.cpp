@@ -6,49 +6,453 @@
 #include <chrono>
 #include <algorithm>
 #include <iomanip>
+#include <thread>
+#include <climits>
+#include <cstdlib>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <atomic>
+#include <set>
+#include <array>
+#include <cmath>
 
 const double BRUTE_FORCE_TIME = 5.0;
+const double CHECKPOINT_INTERVAL = 5.0;
+
+// Adaptive control (--adaptive): mutation rate follows progress, the population
+// shrinks once it has converged, and stagnation triggers a restart keeping the elite.
+const double DIVERSITY_FLOOR = 0.05;
+const int MIN_POP_SIZE = 500;
+const int ELITE_COUNT = 50;
+const int MAX_RESTARTS = 3;
+const double MIN_MUTATION_RATE = 0.005;
+const double MAX_MUTATION_RATE = 0.25;
+
+// Number of problems evolved in lockstep by genetic_algorithm_batch (--batch).
+const size_t BATCH_SIZE = 8;
+
+// Warm start (--warm-start): genomes sampled per generation into the archive,
+// and the share of the initial population seeded from it.
+const size_t ARCHIVE_SAMPLES = 64;
+const size_t ARCHIVE_BUCKETS = 256;
+const size_t ARCHIVE_BUCKET_SIZE = 16;
+const double WARM_SEED_SHARE = 0.25;
+
+// Heuristic seeding (--heuristic-seed): chance that the greedy constructor skips
+// a weight that would still fit, which keeps greedy individuals distinct.
+const double GREEDY_SKIP_PROBABILITY = 0.3;
 
 struct Result {
     int problemNumber;
     double timeTaken;
-    int bestFitness;
+    long long bestFitness;
     bool stoppedByCondition;
     int lastGeneration;
+    // --portfolio: the exact engine completed its sweep, so bestFitness is optimal.
+    bool provedByExact = false;
+};
+
+// State of an unfinished genetic_algorithm run, enough to continue it after a restart.
+struct GAState {
+    int generation = 0;
+    long long bestFitness = LLONG_MAX;
+    int noImprovementCount = 0;
+    double elapsed = 0.0;
+    double mutationRate = 0.0;
+    int restarts = 0;
+    std::vector<std::vector<int>> population;
+};
+
+// Shared between the engines racing on one problem (--portfolio): a flag that tells
+// the others to stop once one engine has proved optimality (the GA by reaching
+// fitness 0, the exact engine by finishing its sweep). Intermediate fitnesses are not
+// shared, since neither engine can prune with a bound the other has not proved.
+struct RaceState {
+    std::atomic<bool> done{false};
+};
+
+// Completed results of the current file plus the in-flight population, written
+// every CHECKPOINT_INTERVAL seconds as a compact binary snapshot (genomes are bit-packed).
+struct Checkpoint {
+    std::string filename;
+    size_t problemCount = 0;
+    std::vector<Result> results;
+    GAState state;
+    std::chrono::high_resolution_clock::time_point lastSave = std::chrono::high_resolution_clock::now();
 };
 
-std::vector<std::vector<int>> load_problems(const std::string& filename) {
-    std::vector<std::vector<int>> problems;
+const char CHECKPOINT_MAGIC[4] = {'G', 'A', 'C', 'P'};
+const uint32_t CHECKPOINT_VERSION = 4;
+
+template <typename T>
+void write_pod(std::ofstream& out, const T& value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+bool read_pod(std::ifstream& in, T& value) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+void save_checkpoint(Checkpoint& checkpoint) {
+    std::string tmp_filename = checkpoint.filename + ".tmp";
+    std::ofstream out(tmp_filename, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Unable to write checkpoint: " << tmp_filename << "\n";
+        return;
+    }
+
+    out.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    write_pod(out, CHECKPOINT_VERSION);
+    write_pod(out, static_cast<uint32_t>(checkpoint.problemCount));
+    write_pod(out, static_cast<uint32_t>(checkpoint.results.size()));
+    for (const auto& r : checkpoint.results) {
+        write_pod(out, static_cast<int32_t>(r.problemNumber));
+        write_pod(out, r.timeTaken);
+        write_pod(out, static_cast<int64_t>(r.bestFitness));
+        write_pod(out, static_cast<uint8_t>(r.stoppedByCondition));
+        write_pod(out, static_cast<int32_t>(r.lastGeneration));
+        write_pod(out, static_cast<uint8_t>(r.provedByExact));
+    }
+
+    const GAState& state = checkpoint.state;
+    uint32_t pop_size = state.population.size();
+    uint32_t n = pop_size > 0 ? state.population[0].size() : 0;
+    write_pod(out, static_cast<int32_t>(state.generation));
+    write_pod(out, static_cast<int64_t>(state.bestFitness));
+    write_pod(out, static_cast<int32_t>(state.noImprovementCount));
+    write_pod(out, state.elapsed);
+    write_pod(out, state.mutationRate);
+    write_pod(out, static_cast<int32_t>(state.restarts));
+    write_pod(out, pop_size);
+    write_pod(out, n);
+    std::vector<char> packed((n + 7) / 8);
+    for (const auto& individual : state.population) {
+        std::fill(packed.begin(), packed.end(), 0);
+        for (uint32_t i = 0; i < n; i++) {
+            if (individual[i] == 1) packed[i / 8] |= 1 << (i % 8);
+        }
+        out.write(packed.data(), packed.size());
+    }
+    out.close();
+
+    std::rename(tmp_filename.c_str(), checkpoint.filename.c_str());
+    checkpoint.lastSave = std::chrono::high_resolution_clock::now();
+}
+
+bool load_checkpoint(Checkpoint& checkpoint) {
+    std::ifstream in(checkpoint.filename, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    char magic[4];
+    uint32_t version = 0, problem_count = 0, result_count = 0;
+    in.read(magic, sizeof(magic));
+    if (!in || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0 ||
+        !read_pod(in, version) || version != CHECKPOINT_VERSION ||
+        !read_pod(in, problem_count) || problem_count != checkpoint.problemCount ||
+        !read_pod(in, result_count) || result_count > problem_count) {
+        std::cerr << "Checkpoint " << checkpoint.filename << " does not match, starting over\n";
+        return false;
+    }
+
+    std::vector<Result> results(result_count);
+    for (auto& r : results) {
+        int32_t problem_number, last_generation;
+        int64_t best_fitness;
+        uint8_t stopped, proved;
+        if (!read_pod(in, problem_number) || !read_pod(in, r.timeTaken) || !read_pod(in, best_fitness) ||
+            !read_pod(in, stopped) || !read_pod(in, last_generation) || !read_pod(in, proved)) return false;
+        r.problemNumber = problem_number;
+        r.bestFitness = best_fitness;
+        r.stoppedByCondition = stopped != 0;
+        r.lastGeneration = last_generation;
+        r.provedByExact = proved != 0;
+    }
+
+    GAState state;
+    int32_t generation, no_improvement_count, restarts;
+    int64_t best_fitness;
+    uint32_t pop_size, n;
+    if (!read_pod(in, generation) || !read_pod(in, best_fitness) || !read_pod(in, no_improvement_count) ||
+        !read_pod(in, state.elapsed) || !read_pod(in, state.mutationRate) || !read_pod(in, restarts) ||
+        !read_pod(in, pop_size) || !read_pod(in, n)) return false;
+    state.generation = generation;
+    state.bestFitness = best_fitness;
+    state.noImprovementCount = no_improvement_count;
+    state.restarts = restarts;
+    state.population.assign(pop_size, std::vector<int>(n));
+    std::vector<char> packed((n + 7) / 8);
+    for (auto& individual : state.population) {
+        if (!in.read(packed.data(), packed.size())) return false;
+        for (uint32_t i = 0; i < n; i++) {
+            individual[i] = (packed[i / 8] >> (i % 8)) & 1;
+        }
+    }
+
+    checkpoint.results = std::move(results);
+    checkpoint.state = std::move(state);
+    return true;
+}
+
+void maybe_save_checkpoint(Checkpoint& checkpoint) {
+    auto now = std::chrono::high_resolution_clock::now();
+    if (std::chrono::duration<double>(now - checkpoint.lastSave).count() >= CHECKPOINT_INTERVAL) {
+        save_checkpoint(checkpoint);
+    }
+}
+
+std::vector<std::vector<long long>> load_problems(const std::string& filename) {
+    std::vector<std::vector<long long>> problems;
     std::ifstream file(filename);
     std::string line;
 
     while (std::getline(file, line)) {
-        std::vector<int> problem;
+        std::vector<long long> problem;
         size_t pos = 0;
         std::string token;
         while ((pos = line.find(',')) != std::string::npos) {
             token = line.substr(0, pos);
-            problem.push_back(std::stoi(token));
+            problem.push_back(std::stoll(token));
             line.erase(0, pos + 1);
         }
-        problem.push_back(std::stoi(line));
+        problem.push_back(std::stoll(line));
         problems.push_back(problem);
     }
     file.close();
     return problems;
 }
 
-int fitness(const std::vector<int>& individual, const std::vector<int>& weights, int target_weight) {
-    int total_weight = 0;
+// Largest value of a signed weight type, also for __int128 where numeric_limits
+// is not specialized in strict ISO mode.
+template <typename Weight>
+constexpr Weight max_weight() {
+    Weight half = Weight(1) << (sizeof(Weight) * 8 - 2);
+    return half - 1 + half;
+}
+
+template <typename Weight>
+Weight abs_diff(Weight a, Weight b) {
+    return a > b ? a - b : b - a;
+}
+
+// Fitness as reported in results, clamped for __int128 sums.
+template <typename Weight>
+long long to_report(Weight value) {
+    if constexpr (sizeof(Weight) > sizeof(long long)) {
+        if (value > static_cast<Weight>(LLONG_MAX)) return LLONG_MAX;
+    }
+    return static_cast<long long>(value);
+}
+
+// Subset weight for a fixed n: the loop has a constant trip count and no branches,
+// so it is fully unrolled and vectorized.
+template <int N, typename Weight>
+Weight subset_weight_fixed(const int* individual, const Weight* weights) {
+    Weight total_weight = 0;
+#pragma GCC unroll 64
+    for (int i = 0; i < N; i++) {
+        total_weight += Weight(individual[i] & 1) * weights[i];
+    }
+    return total_weight;
+}
+
+template <typename Weight>
+Weight subset_weight(const std::vector<int>& individual, const std::vector<Weight>& weights) {
+    switch (individual.size()) {
+        case 16: return subset_weight_fixed<16>(individual.data(), weights.data());
+        case 24: return subset_weight_fixed<24>(individual.data(), weights.data());
+        case 32: return subset_weight_fixed<32>(individual.data(), weights.data());
+        case 48: return subset_weight_fixed<48>(individual.data(), weights.data());
+        case 64: return subset_weight_fixed<64>(individual.data(), weights.data());
+    }
+    Weight total_weight = 0;
     for (size_t i = 0; i < individual.size(); i++) {
         if (individual[i] == 1) total_weight += weights[i];
     }
-    return std::abs(target_weight - total_weight);
+    return total_weight;
+}
+
+template <typename Weight>
+Weight fitness(const std::vector<int>& individual, const std::vector<Weight>& weights, Weight target_weight) {
+    return abs_diff(target_weight, subset_weight(individual, weights));
+}
+
+// Genome of up to 64 genes packed into one word, bit i = gene i.
+uint64_t pack_individual(const std::vector<int>& individual) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < individual.size(); i++) {
+        key |= uint64_t(individual[i] == 1) << i;
+    }
+    return key;
+}
+
+// Bounded open-addressing cache of subset weight sums keyed by packed genome
+// (--fitness-cache). Sums do not depend on the target, so the cache stays valid
+// for all problems sharing a weight vector. A key that finds no free slot within
+// MAX_PROBES evicts the entry at its home slot.
+template <typename Weight>
+class FitnessCache {
+public:
+    static const size_t MAX_PROBES = 8;
+
+    explicit FitnessCache(int capacity_log2 = 16)
+        : slots_(size_t(1) << capacity_log2), mask_(slots_.size() - 1) {}
+
+    bool lookup(uint64_t key, Weight& sum) {
+        for (size_t probe = 0, pos = home(key); probe < MAX_PROBES; probe++, pos = (pos + 1) & mask_) {
+            if (!slots_[pos].used) break;
+            if (slots_[pos].key == key) {
+                sum = slots_[pos].sum;
+                hits++;
+                return true;
+            }
+        }
+        misses++;
+        return false;
+    }
+
+    void insert(uint64_t key, Weight sum) {
+        size_t pos = home(key);
+        for (size_t probe = 0; probe < MAX_PROBES; probe++) {
+            size_t p = (pos + probe) & mask_;
+            if (!slots_[p].used || slots_[p].key == key) {
+                slots_[p] = {key, sum, true};
+                return;
+            }
+        }
+        slots_[pos] = {key, sum, true};
+    }
+
+    void clear() {
+        std::fill(slots_.begin(), slots_.end(), Slot());
+        hits = misses = 0;
+    }
+
+    double hit_rate() const {
+        return hits + misses > 0 ? static_cast<double>(hits) / (hits + misses) : 0.0;
+    }
+
+    size_t hits = 0;
+    size_t misses = 0;
+
+private:
+    struct Slot {
+        uint64_t key = 0;
+        Weight sum = 0;
+        bool used = false;
+    };
+
+    size_t home(uint64_t key) const {
+        return (key * 0x9E3779B97F4A7C15ULL) >> 32 & mask_;
+    }
+
+    std::vector<Slot> slots_;
+    size_t mask_;
+};
+
+template <typename Weight>
+Weight cached_fitness(const std::vector<int>& individual, const std::vector<Weight>& weights, Weight target_weight,
+                      FitnessCache<Weight>& cache) {
+    uint64_t key = pack_individual(individual);
+    Weight total_weight;
+    if (!cache.lookup(key, total_weight)) {
+        total_weight = subset_weight(individual, weights);
+        cache.insert(key, total_weight);
+    }
+    return abs_diff(target_weight, total_weight);
+}
+
+// Evaluated genomes of one weight vector with their subset sums, bucketed by sum so
+// that the whole range [0, total weight] stays represented. Sums do not depend on the
+// target, so seeding a run for a new target rescores each entry in O(1).
+template <typename Weight>
+class GenomeArchive {
+public:
+    void reset(const std::vector<Weight>& weights) {
+        total_weight_ = 0;
+        for (Weight w : weights) total_weight_ += w;
+        buckets_.assign(ARCHIVE_BUCKETS, {});
+    }
+
+    bool empty() const {
+        return std::all_of(buckets_.begin(), buckets_.end(), [](const std::vector<Entry>& b) { return b.empty(); });
+    }
+
+    void add(const std::vector<int>& genome, Weight sum) {
+        if (buckets_.empty() || total_weight_ <= 0) return;
+        size_t index = std::min<size_t>(ARCHIVE_BUCKETS - 1,
+                                        static_cast<size_t>(static_cast<double>(sum) / static_cast<double>(total_weight_) * ARCHIVE_BUCKETS));
+        auto& bucket = buckets_[index];
+        for (const auto& entry : bucket) {
+            if (entry.sum == sum && entry.genome == genome) return;
+        }
+        if (bucket.size() < ARCHIVE_BUCKET_SIZE) {
+            bucket.push_back({genome, sum});
+        } else {
+            bucket[next_slot_++ % ARCHIVE_BUCKET_SIZE] = {genome, sum};
+        }
+    }
+
+    // Up to count archived genomes closest to target_weight.
+    std::vector<std::vector<int>> seeds(Weight target_weight, size_t count) const {
+        std::vector<std::pair<Weight, const std::vector<int>*>> scored;
+        for (const auto& bucket : buckets_) {
+            for (const auto& entry : bucket) {
+                scored.push_back({abs_diff(target_weight, entry.sum), &entry.genome});
+            }
+        }
+        count = std::min(count, scored.size());
+        std::partial_sort(scored.begin(), scored.begin() + count, scored.end(),
+                          [](const auto& a, const auto& b) { return a.first < b.first; });
+        std::vector<std::vector<int>> result;
+        for (size_t i = 0; i < count; i++) result.push_back(*scored[i].second);
+        return result;
+    }
+
+private:
+    struct Entry {
+        std::vector<int> genome;
+        Weight sum;
+    };
+
+    Weight total_weight_ = 0;
+    size_t next_slot_ = 0;
+    std::vector<std::vector<Entry>> buckets_;
+};
+
+// Per-thread generator, seeded once rather than on every call.
+std::mt19937& rng() {
+    thread_local std::mt19937 gen(std::random_device{}());
+    return gen;
+}
+
+// Calls flip(i) for every gene that mutates with probability rate. Gaps between
+// flipped genes are drawn from a geometric distribution, so the number of draws is
+// the number of flips plus one instead of one per gene.
+template <typename Gen, typename Flip>
+void for_each_mutation(int n, double rate, Gen& gen, Flip flip) {
+    if (rate <= 0) return;
+    if (rate >= 1) {
+        for (int i = 0; i < n; i++) flip(i);
+        return;
+    }
+    std::geometric_distribution<int> gap(rate);
+    for (long long i = gap(gen); i < n; i += 1 + static_cast<long long>(gap(gen))) {
+        flip(static_cast<int>(i));
+    }
+}
+
+// Mutation of a packed genome as an XOR mask.
+template <typename Gen>
+uint64_t mutation_mask(int n, double rate, Gen& gen) {
+    uint64_t mask = 0;
+    for_each_mutation(n, rate, gen, [&](int i) { mask |= uint64_t(1) << i; });
+    return mask;
 }
 
 std::vector<int> create_individual(int n) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937& gen = rng();
     std::uniform_int_distribution<> dis(0, 1);
 
     std::vector<int> individual(n);
@@ -66,14 +470,83 @@ std::vector<std::vector<int>> create_population(int pop_size, int n) {
     return population;
 }
 
+// Includes each item with probability p = target / total weight, so the expected
+// subset sum equals the target instead of half the total.
+std::vector<int> create_biased_individual(int n, double p, std::mt19937& gen) {
+    std::bernoulli_distribution dis(p);
+    std::vector<int> individual(n);
+    for (int i = 0; i < n; i++) {
+        individual[i] = dis(gen);
+    }
+    return individual;
+}
+
+// Randomized greedy fill: walks the weights in descending order and takes every
+// weight that still fits under the target, skipping some at random.
+template <typename Weight>
+std::vector<int> create_greedy_individual(const std::vector<Weight>& weights, const std::vector<int>& order,
+                                          Weight target_weight, std::mt19937& gen) {
+    std::bernoulli_distribution skip(GREEDY_SKIP_PROBABILITY);
+    std::vector<int> individual(weights.size(), 0);
+    Weight total_weight = 0;
+    for (int i : order) {
+        if (weights[i] <= target_weight - total_weight && !skip(gen)) {
+            individual[i] = 1;
+            total_weight += weights[i];
+        }
+    }
+    return individual;
+}
+
+// Population split evenly between biased, greedy and uniform random individuals,
+// built in parallel with one generator per thread.
+template <typename Weight>
+std::vector<std::vector<int>> create_seeded_population(int pop_size, const std::vector<Weight>& weights, Weight target_weight) {
+    int n = weights.size();
+    Weight total = 0;
+    for (Weight w : weights) total += w;
+    double p = total > 0 ? std::min(1.0, std::max(0.0, static_cast<double>(target_weight) / static_cast<double>(total))) : 0.5;
+
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return weights[a] > weights[b]; });
+
+    std::vector<std::vector<int>> population(pop_size);
+    unsigned int num_threads = std::thread::hardware_concurrency();
+    if (num_threads == 0) num_threads = 4;
+    num_threads = std::min<unsigned int>(num_threads, std::max(1, pop_size / 1000));
+
+    std::random_device rd;
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < num_threads; t++) {
+        unsigned int seed = rd();
+        threads.emplace_back([&, t, seed]() {
+            std::mt19937 gen(seed);
+            for (int k = t; k < pop_size; k += num_threads) {
+                switch (k % 3) {
+                    case 0: population[k] = create_biased_individual(n, p, gen); break;
+                    case 1: population[k] = create_greedy_individual(weights, order, target_weight, gen); break;
+                    default: population[k] = create_biased_individual(n, 0.5, gen); break;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    return population;
+}
+
+template <typename Weight>
 std::vector<std::vector<int>> tournament_selection(const std::vector<std::vector<int>>& population,
-                                                 const std::vector<int>& fitnesses,
+                                                 const std::vector<Weight>& fitnesses,
+                                                 size_t count,
                                                  int tournament_size = 3) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937& gen = rng();
     std::vector<std::vector<int>> selected;
+    selected.reserve(count);
 
-    for (size_t i = 0; i < population.size(); i++) {
+    for (size_t i = 0; i < count; i++) {
         std::vector<int> candidates(tournament_size);
         for (int j = 0; j < tournament_size; j++) {
             candidates[j] = std::uniform_int_distribution<>(0, population.size() - 1)(gen);
@@ -85,70 +558,208 @@ std::vector<std::vector<int>> tournament_selection(const std::vector<std::vector
     return selected;
 }
 
+// Tail swap for a fixed n as a branch-free blend over the whole genome.
+template <int N>
+void swap_tails_fixed(int* child1, int* child2, int point) {
+#pragma GCC unroll 64
+    for (int i = 0; i < N; i++) {
+        int tail = -(i >= point);
+        int diff = (child1[i] ^ child2[i]) & tail;
+        child1[i] ^= diff;
+        child2[i] ^= diff;
+    }
+}
+
 std::pair<std::vector<int>, std::vector<int>> crossover(const std::vector<int>& parent1,
                                                        const std::vector<int>& parent2) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    int point = std::uniform_int_distribution<>(1, parent1.size() - 1)(gen);
+    int point = std::uniform_int_distribution<>(1, parent1.size() - 1)(rng());
 
-    std::vector<int> child1(parent1.begin(), parent1.begin() + point);
-    child1.insert(child1.end(), parent2.begin() + point, parent2.end());
-
-    std::vector<int> child2(parent2.begin(), parent2.begin() + point);
-    child2.insert(child2.end(), parent1.begin() + point, parent1.end());
-
-    return {child1, child2};
+    std::pair<std::vector<int>, std::vector<int>> children(parent1, parent2);
+    int* child1 = children.first.data();
+    int* child2 = children.second.data();
+    switch (parent1.size()) {
+        case 16: swap_tails_fixed<16>(child1, child2, point); break;
+        case 24: swap_tails_fixed<24>(child1, child2, point); break;
+        case 32: swap_tails_fixed<32>(child1, child2, point); break;
+        case 48: swap_tails_fixed<48>(child1, child2, point); break;
+        case 64: swap_tails_fixed<64>(child1, child2, point); break;
+        default:
+            std::swap_ranges(children.first.begin() + point, children.first.end(), children.second.begin() + point);
+    }
+    return children;
 }
 
 std::vector<int> mutate(std::vector<int> individual, double mutation_rate = 0.01) {
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<> dis(0, 1);
+    for_each_mutation(individual.size(), mutation_rate, rng(), [&](int i) { individual[i] = 1 - individual[i]; });
+    return individual;
+}
 
-    for (size_t i = 0; i < individual.size(); i++) {
-        if (dis(gen) < mutation_rate) {
-            individual[i] = 1 - individual[i];
+// Packs every individual into 64-bit words, one bit per gene.
+std::vector<uint64_t> pack_population(const std::vector<std::vector<int>>& population, int n) {
+    size_t words = (n + 63) / 64;
+    std::vector<uint64_t> packed(population.size() * words, 0);
+    for (size_t k = 0; k < population.size(); k++) {
+        for (int i = 0; i < n; i++) {
+            if (population[k][i] == 1) packed[k * words + i / 64] |= uint64_t(1) << (i % 64);
         }
     }
-    return individual;
+    return packed;
+}
+
+// Mean over loci of 4p(1-p), where p is the share of ones at the locus:
+// about 1 for a random population and 0 once all individuals are identical.
+double population_diversity(const std::vector<uint64_t>& packed, size_t pop_size, int n) {
+    size_t words = (n + 63) / 64;
+    std::vector<size_t> ones(words * 64, 0);
+    for (size_t k = 0; k < pop_size; k++) {
+        for (size_t w = 0; w < words; w++) {
+            for (uint64_t bits = packed[k * words + w]; bits != 0; bits &= bits - 1) {
+                ones[w * 64 + __builtin_ctzll(bits)]++;
+            }
+        }
+    }
+    double diversity = 0;
+    for (int i = 0; i < n; i++) {
+        double p = static_cast<double>(ones[i]) / pop_size;
+        diversity += 4 * p * (1 - p);
+    }
+    return diversity / n;
 }
 
-Result genetic_algorithm(const std::vector<int>& problem, int target_weight,
+// Best distinct individuals, compared by their packed genomes.
+template <typename Weight>
+std::vector<std::vector<int>> select_elite(const std::vector<std::vector<int>>& population,
+                                           const std::vector<Weight>& fitnesses,
+                                           const std::vector<uint64_t>& packed, int n, size_t count) {
+    size_t words = (n + 63) / 64;
+    std::vector<size_t> order(population.size());
+    for (size_t k = 0; k < order.size(); k++) order[k] = k;
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return fitnesses[a] < fitnesses[b]; });
+
+    std::vector<std::vector<int>> elite;
+    std::vector<size_t> elite_indices;
+    for (size_t k : order) {
+        if (elite.size() >= count) break;
+        bool duplicate = std::any_of(elite_indices.begin(), elite_indices.end(), [&](size_t e) {
+            return std::equal(packed.begin() + k * words, packed.begin() + (k + 1) * words, packed.begin() + e * words);
+        });
+        if (duplicate) continue;
+        elite_indices.push_back(k);
+        elite.push_back(population[k]);
+    }
+    return elite;
+}
+
+template <typename Weight>
+Result genetic_algorithm(const std::vector<Weight>& problem, Weight target_weight,
+                        Checkpoint* checkpoint = nullptr, bool adaptive = false,
+                        FitnessCache<Weight>* cache = nullptr, GenomeArchive<Weight>* archive = nullptr,
+                        bool heuristic_seed = false, RaceState* race = nullptr,
                         int pop_size = 10000, int max_generations = 1000,
                         double mutation_rate = 0.03) {
-    std::vector<int> weights(problem.begin(), problem.end() - 1);
+    std::vector<Weight> weights(problem.begin(), problem.end() - 1);
     int n = weights.size();
-    auto population = create_population(pop_size, n);
-    int best_fitness = INT_MAX;
+    if (n > 64) cache = nullptr;
+    auto new_population = [&](int count) {
+        return heuristic_seed ? create_seeded_population(count, weights, target_weight) : create_population(count, n);
+    };
+    std::vector<std::vector<int>> population;
+    Weight best_fitness = max_weight<Weight>();
     int no_improvement_count = 0;
+    int generation = 0;
+    int restarts = 0;
+    const double base_mutation_rate = mutation_rate;
 
     auto start_time = std::chrono::high_resolution_clock::now();
+    if (checkpoint && !checkpoint->state.population.empty()) {
+        GAState& state = checkpoint->state;
+        population = std::move(state.population);
+        best_fitness = state.bestFitness;
+        no_improvement_count = state.noImprovementCount;
+        generation = state.generation;
+        restarts = state.restarts;
+        if (state.mutationRate > 0) mutation_rate = state.mutationRate;
+        pop_size = population.size();
+        start_time -= std::chrono::duration_cast<std::chrono::high_resolution_clock::duration>(
+            std::chrono::duration<double>(state.elapsed));
+        state = GAState();
+    } else if (archive && !archive->empty()) {
+        population = archive->seeds(target_weight, static_cast<size_t>(pop_size * WARM_SEED_SHARE));
+        auto random_part = new_population(pop_size - population.size());
+        population.insert(population.end(), random_part.begin(), random_part.end());
+    } else {
+        population = new_population(pop_size);
+    }
     auto last_improvement_time = start_time;
 
-    int generation = 0;
     for (; generation < max_generations; generation++) {
-        std::vector<int> fitnesses(pop_size);
-        for (int i = 0; i < pop_size; i++) {
-            fitnesses[i] = fitness(population[i], weights, target_weight);
+        if (race && race->done) break;
+        if (checkpoint) {
+            auto now = std::chrono::high_resolution_clock::now();
+            if (std::chrono::duration<double>(now - checkpoint->lastSave).count() >= CHECKPOINT_INTERVAL) {
+                checkpoint->state = {generation, to_report(best_fitness), no_improvement_count,
+                                     std::chrono::duration<double>(now - start_time).count(),
+                                     mutation_rate, restarts, population};
+                save_checkpoint(*checkpoint);
+                checkpoint->state = GAState();
+            }
         }
 
-        int current_best = *std::min_element(fitnesses.begin(), fitnesses.end());
-        if (current_best < best_fitness) {
+        std::vector<Weight> fitnesses(population.size());
+        for (size_t i = 0; i < population.size(); i++) {
+            fitnesses[i] = cache ? cached_fitness(population[i], weights, target_weight, *cache)
+                                 : fitness(population[i], weights, target_weight);
+        }
+
+        if (archive) {
+            size_t stride = std::max<size_t>(1, population.size() / ARCHIVE_SAMPLES);
+            for (size_t i = 0; i < population.size(); i += stride) {
+                archive->add(population[i], subset_weight(population[i], weights));
+            }
+        }
+
+        Weight current_best = *std::min_element(fitnesses.begin(), fitnesses.end());
+        bool improved = current_best < best_fitness;
+        if (improved) {
             best_fitness = current_best;
             no_improvement_count = 0;
             last_improvement_time = std::chrono::high_resolution_clock::now();
         } else {
             no_improvement_count++;
         }
+        if (best_fitness == 0) {
+            if (race) race->done = true;
+            break;
+        }
+
+        if (adaptive) {
+            auto packed = pack_population(population, n);
+            double diversity = population_diversity(packed, population.size(), n);
+
+            mutation_rate = improved ? std::max(MIN_MUTATION_RATE, mutation_rate * 0.8)
+                                     : std::min(MAX_MUTATION_RATE, mutation_rate * 1.5);
+            if (diversity < DIVERSITY_FLOOR) {
+                pop_size = std::max(MIN_POP_SIZE, pop_size / 2);
+            }
+
+            if (no_improvement_count >= 2 && restarts < MAX_RESTARTS) {
+                auto elite = select_elite(population, fitnesses, packed, n, ELITE_COUNT);
+                population = new_population(pop_size - elite.size());
+                population.insert(population.end(), elite.begin(), elite.end());
+                mutation_rate = base_mutation_rate;
+                no_improvement_count = 0;
+                restarts++;
+                continue;
+            }
+        }
 
-        if (best_fitness == 0) break;
         if (no_improvement_count >= 2) break;
 
         auto current_time = std::chrono::high_resolution_clock::now();
         double time_elapsed = std::chrono::duration<double>(current_time - start_time).count();
         if (time_elapsed > 2 * BRUTE_FORCE_TIME) break;
 
-        auto selected = tournament_selection(population, fitnesses);
+        auto selected = tournament_selection(population, fitnesses, pop_size);
         std::vector<std::vector<int>> next_population;
         for (size_t i = 0; i < selected.size() - 1; i += 2) {
             auto [child1, child2] = crossover(selected[i], selected[i + 1]);
@@ -164,39 +775,653 @@ Result genetic_algorithm(const std::vector<int>& problem, int target_weight,
     bool stopped_by_condition = (no_improvement_count >= 2) ||
                                (std::chrono::duration<double>(end_time - start_time).count() > 2 * BRUTE_FORCE_TIME);
 
-    return {0, time_taken, best_fitness, stopped_by_condition, generation};
+    return {0, time_taken, to_report(best_fitness), stopped_by_condition, generation};
 }
 
-void process_file(int file_num) {
-    std::string input_file = "knapsack_problems_" + std::to_string(file_num) + ".csv";
-    std::string output_file = "genetic_knapsack_solutions_" + std::to_string(file_num) + ".csv";
+// Evolves up to BATCH_SIZE problems with the same n at once. Genomes are packed into
+// one word and stored lane-interleaved (individual k of problem l at k * lanes + l),
+// so sums, crossover masks and mutation masks are computed over all problems in one
+// vectorizable inner loop. All lanes share the random draws (tournament candidates,
+// crossover points, mutation masks); winners still differ because each lane compares
+// its own fitnesses. A lane's result is frozen when it meets the stop conditions of
+// genetic_algorithm, and the batch ends when every lane has stopped.
+template <typename Weight>
+std::vector<Result> genetic_algorithm_batch(const std::vector<std::vector<Weight>>& problems,
+                                            int pop_size = 10000, int max_generations = 1000,
+                                            double mutation_rate = 0.03, int tournament_size = 3) {
+    const size_t lanes = problems.size();
+    const int n = problems[0].size() - 1;
 
-    auto problems = load_problems(input_file);
+    std::vector<Weight> weights(n * lanes);
+    std::vector<Weight> targets(lanes);
+    for (size_t l = 0; l < lanes; l++) {
+        for (int i = 0; i < n; i++) weights[i * lanes + l] = problems[l][i];
+        targets[l] = problems[l].back();
+    }
+
+    std::random_device rd;
+    std::mt19937_64 gen(rd());
+    std::uniform_int_distribution<int> pick(0, pop_size - 1);
+    std::uniform_int_distribution<int> cut(1, n - 1);
+    const uint64_t genome_mask = n == 64 ? ~uint64_t(0) : (uint64_t(1) << n) - 1;
+
+    std::vector<uint64_t> population(pop_size * lanes);
+    for (auto& genome : population) genome = gen() & genome_mask;
+    std::vector<uint64_t> selected(pop_size * lanes);
+    std::vector<Weight> sums(pop_size * lanes);
+    std::vector<Weight> fitnesses(pop_size * lanes);
+
+    std::vector<Result> results(lanes, Result{0, 0.0, LLONG_MAX, false, 0});
+    std::vector<Weight> best_fitness(lanes, max_weight<Weight>());
+    std::vector<int> no_improvement_count(lanes, 0);
+    std::vector<bool> active(lanes, true);
+    size_t active_count = lanes;
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (int generation = 0; generation < max_generations && active_count > 0; generation++) {
+        std::fill(sums.begin(), sums.end(), 0);
+        for (int k = 0; k < pop_size; k++) {
+            const uint64_t* genome = &population[k * lanes];
+            Weight* sum = &sums[k * lanes];
+            for (int i = 0; i < n; i++) {
+                const Weight* w = &weights[i * lanes];
+                for (size_t l = 0; l < lanes; l++) {
+                    sum[l] += static_cast<Weight>((genome[l] >> i) & 1) * w[l];
+                }
+            }
+        }
+        for (int k = 0; k < pop_size; k++) {
+            for (size_t l = 0; l < lanes; l++) {
+                fitnesses[k * lanes + l] = abs_diff(targets[l], sums[k * lanes + l]);
+            }
+        }
+
+        double time_elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+        for (size_t l = 0; l < lanes; l++) {
+            if (!active[l]) continue;
+            Weight current_best = max_weight<Weight>();
+            for (int k = 0; k < pop_size; k++) current_best = std::min(current_best, fitnesses[k * lanes + l]);
+            if (current_best < best_fitness[l]) {
+                best_fitness[l] = current_best;
+                no_improvement_count[l] = 0;
+            } else {
+                no_improvement_count[l]++;
+            }
+
+            bool stopped_by_condition = no_improvement_count[l] >= 2 || time_elapsed > 2 * BRUTE_FORCE_TIME;
+            if (best_fitness[l] == 0 || stopped_by_condition || generation + 1 == max_generations) {
+                results[l] = {0, time_elapsed, to_report(best_fitness[l]), stopped_by_condition, generation};
+                active[l] = false;
+                active_count--;
+            }
+        }
+        if (active_count == 0) break;
+
+        for (int k = 0; k < pop_size; k++) {
+            int first = pick(gen);
+            uint64_t* out = &selected[k * lanes];
+            for (size_t l = 0; l < lanes; l++) out[l] = population[first * lanes + l];
+            std::array<Weight, BATCH_SIZE> winner_fitness;
+            std::copy(fitnesses.begin() + first * lanes, fitnesses.begin() + (first + 1) * lanes, winner_fitness.begin());
+            for (int j = 1; j < tournament_size; j++) {
+                int candidate = pick(gen);
+                for (size_t l = 0; l < lanes; l++) {
+                    bool better = fitnesses[candidate * lanes + l] < winner_fitness[l];
+                    out[l] = better ? population[candidate * lanes + l] : out[l];
+                    winner_fitness[l] = better ? fitnesses[candidate * lanes + l] : winner_fitness[l];
+                }
+            }
+        }
+
+        for (int k = 0; k + 1 < pop_size; k += 2) {
+            uint64_t low = (uint64_t(1) << cut(gen)) - 1;
+            uint64_t flip1 = mutation_mask(n, mutation_rate, gen);
+            uint64_t flip2 = mutation_mask(n, mutation_rate, gen);
+            const uint64_t* parent1 = &selected[k * lanes];
+            const uint64_t* parent2 = &selected[(k + 1) * lanes];
+            uint64_t* child1 = &population[k * lanes];
+            uint64_t* child2 = &population[(k + 1) * lanes];
+            for (size_t l = 0; l < lanes; l++) {
+                child1[l] = ((parent1[l] & low) | (parent2[l] & ~low)) ^ flip1;
+                child2[l] = ((parent2[l] & low) | (parent1[l] & ~low)) ^ flip2;
+            }
+        }
+    }
+
+    return results;
+}
+
+// Max-heap of individual indices keyed by fitness, with each index's heap position
+// tracked so that a replaced individual is re-sifted in O(log n).
+template <typename Weight>
+class WorstHeap {
+public:
+    explicit WorstHeap(const std::vector<Weight>& fitnesses) : fitnesses_(fitnesses), heap_(fitnesses.size()), pos_(fitnesses.size()) {
+        for (size_t i = 0; i < heap_.size(); i++) heap_[i] = pos_[i] = i;
+        for (size_t i = heap_.size() / 2; i-- > 0;) sift_down(i);
+    }
+
+    size_t worst() const { return heap_[0]; }
+    Weight worst_fitness() const { return fitnesses_[heap_[0]]; }
+
+    void update(size_t index, Weight fitness) {
+        Weight old = fitnesses_[index];
+        fitnesses_[index] = fitness;
+        if (fitness > old) sift_up(pos_[index]);
+        else sift_down(pos_[index]);
+    }
+
+private:
+    void swap_nodes(size_t a, size_t b) {
+        std::swap(heap_[a], heap_[b]);
+        pos_[heap_[a]] = a;
+        pos_[heap_[b]] = b;
+    }
+
+    void sift_up(size_t i) {
+        while (i > 0 && fitnesses_[heap_[(i - 1) / 2]] < fitnesses_[heap_[i]]) {
+            swap_nodes(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void sift_down(size_t i) {
+        while (true) {
+            size_t largest = i, left = 2 * i + 1, right = 2 * i + 2;
+            if (left < heap_.size() && fitnesses_[heap_[left]] > fitnesses_[heap_[largest]]) largest = left;
+            if (right < heap_.size() && fitnesses_[heap_[right]] > fitnesses_[heap_[largest]]) largest = right;
+            if (largest == i) return;
+            swap_nodes(i, largest);
+            i = largest;
+        }
+    }
+
+    std::vector<Weight> fitnesses_;
+    std::vector<size_t> heap_;
+    std::vector<size_t> pos_;
+};
+
+// Steady-state variant (--steady-state): each step breeds two children from
+// tournament winners and writes each one over the current worst individual if it
+// is better, so the population is updated in place and never copied. Progress is
+// counted in generation equivalents (pop_size evaluations), and the stop rules
+// match genetic_algorithm: two equivalents without improvement or the time limit.
+template <typename Weight>
+Result genetic_algorithm_steady_state(const std::vector<Weight>& problem, Weight target_weight,
+                                      int pop_size = 10000, int max_generations = 1000,
+                                      double mutation_rate = 0.03, int tournament_size = 3) {
+    std::vector<Weight> weights(problem.begin(), problem.end() - 1);
+    int n = weights.size();
+
+    std::mt19937& gen = rng();
+    std::uniform_int_distribution<int> pick(0, pop_size - 1);
+    std::uniform_int_distribution<int> cut(1, n - 1);
+
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    auto population = create_population(pop_size, n);
+    std::vector<Weight> fitnesses(pop_size);
+    for (int i = 0; i < pop_size; i++) {
+        fitnesses[i] = fitness(population[i], weights, target_weight);
+    }
+    WorstHeap<Weight> heap(fitnesses);
+    Weight best_fitness = *std::min_element(fitnesses.begin(), fitnesses.end());
+
+    auto tournament = [&]() {
+        int winner = pick(gen);
+        for (int j = 1; j < tournament_size; j++) {
+            int candidate = pick(gen);
+            if (fitnesses[candidate] < fitnesses[winner]) winner = candidate;
+        }
+        return winner;
+    };
+
+    std::vector<int> children[2] = {std::vector<int>(n), std::vector<int>(n)};
+    long long evaluations = pop_size;
+    long long last_improvement = evaluations;
+    bool stopped_by_condition = false;
+
+    while (best_fitness != 0 && evaluations < static_cast<long long>(max_generations) * pop_size) {
+        if (evaluations - last_improvement >= 2LL * pop_size) {
+            stopped_by_condition = true;
+            break;
+        }
+        if (evaluations % pop_size < 2) {
+            double time_elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+            if (time_elapsed > 2 * BRUTE_FORCE_TIME) {
+                stopped_by_condition = true;
+                break;
+            }
+        }
+
+        const std::vector<int>& parent1 = population[tournament()];
+        const std::vector<int>& parent2 = population[tournament()];
+        int point = cut(gen);
+        std::copy(parent1.begin(), parent1.begin() + point, children[0].begin());
+        std::copy(parent2.begin() + point, parent2.end(), children[0].begin() + point);
+        std::copy(parent2.begin(), parent2.begin() + point, children[1].begin());
+        std::copy(parent1.begin() + point, parent1.end(), children[1].begin() + point);
+
+        for (auto& child : children) {
+            for_each_mutation(n, mutation_rate, gen, [&](int i) { child[i] = 1 - child[i]; });
+            Weight child_fitness = fitness(child, weights, target_weight);
+            evaluations++;
+            if (child_fitness < heap.worst_fitness()) {
+                size_t slot = heap.worst();
+                population[slot].swap(child);
+                fitnesses[slot] = child_fitness;
+                heap.update(slot, child_fitness);
+            }
+            if (child_fitness < best_fitness) {
+                best_fitness = child_fitness;
+                last_improvement = evaluations;
+            }
+        }
+    }
+
+    double time_taken = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+    return {0, time_taken, to_report(best_fitness), stopped_by_condition, static_cast<int>(evaluations / pop_size)};
+}
+
+// Command line switches of the driver.
+struct Options {
+    bool resume = false;
+    bool adaptive = false;
+    bool useCache = false;
+    bool batch = false;
+    bool warmStart = false;
+    bool heuristicSeed = false;
+    bool steadyState = false;
+    bool portfolio = false;
+    bool value = false;
+    bool summaryOnly = false;
+};
+
+// Exact opponent of the GA in a race: meet in the middle over the two halves of the
+// weights, taking for every left sum the closest right sum to the remaining target.
+// Finishing the sweep proves the optimum, so it then stops the other engines; it
+// gives up early if they report fitness 0 first or after 2 * BRUTE_FORCE_TIME, the
+// GA's own limit. The last generation field is unused.
+template <typename Weight>
+Result exact_closest_subset(const std::vector<Weight>& problem, Weight target_weight, RaceState& race) {
+    std::vector<Weight> weights(problem.begin(), problem.end() - 1);
+    int half = weights.size() / 2;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    auto sums_of = [&](int from, int to) {
+        std::vector<Weight> sums(size_t(1) << (to - from), 0);
+        for (int i = from; i < to; i++) {
+            size_t size = size_t(1) << (i - from);
+            for (size_t mask = 0; mask < size; mask++) sums[size + mask] = sums[mask] + weights[i];
+        }
+        return sums;
+    };
+    std::vector<Weight> left = sums_of(0, half);
+    std::vector<Weight> right = sums_of(half, weights.size());
+    std::sort(right.begin(), right.end());
+
+    auto out_of_time = [&] {
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count() >
+               2 * BRUTE_FORCE_TIME;
+    };
+    Weight best_fitness = max_weight<Weight>();
+    bool finished = true;
+    for (size_t i = 0; i < left.size() && best_fitness != 0; i++) {
+        if (i % 256 == 0 && (race.done || out_of_time())) {
+            finished = false;
+            break;
+        }
+        Weight need = target_weight - left[i];
+        auto it = std::lower_bound(right.begin(), right.end(), need);
+        if (it != right.end()) best_fitness = std::min(best_fitness, abs_diff(*it, need));
+        if (it != right.begin()) best_fitness = std::min(best_fitness, abs_diff(*(it - 1), need));
+    }
+
+    if (finished) race.done = true;
+    double time_taken = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+    return {0, time_taken, to_report(best_fitness), finished, 0};
+}
+
+// Largest n for which the exact engine joins the race (two tables of 2^(n/2) sums).
+const int PORTFOLIO_MAX_EXACT_N = 44;
+
+// Races the GA against the exact engine on separate threads and keeps whichever
+// answer is better. Only a proof cancels the other engine: a GA that merely
+// stagnated leaves the exact sweep running until it finishes or hits its time limit.
+// Time is the wall time until both engines are done.
+// stoppedByCondition and lastGeneration are the GA's; provedByExact is set when the
+// exact engine completed, which makes the returned fitness optimal.
+template <typename Weight>
+Result race_portfolio(const std::vector<Weight>& problem, Weight target_weight, Checkpoint* checkpoint,
+                      const Options& options, FitnessCache<Weight>* cache, GenomeArchive<Weight>* archive) {
+    RaceState race;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    Result exact = {0, 0.0, LLONG_MAX, false, 0};
+    std::thread exact_thread;
+    if (static_cast<int>(problem.size()) - 1 <= PORTFOLIO_MAX_EXACT_N) {
+        exact_thread = std::thread([&] { exact = exact_closest_subset(problem, target_weight, race); });
+    }
+    Result ga = genetic_algorithm(problem, target_weight, checkpoint, options.adaptive, cache, archive,
+                                  options.heuristicSeed, &race);
+    if (exact_thread.joinable()) exact_thread.join();
+
+    double time_taken = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+    return {0, time_taken, std::min(ga.bestFitness, exact.bestFitness), ga.stoppedByCondition, ga.lastGeneration,
+            exact.stoppedByCondition};
+}
+
+// Value-maximizing 0/1 knapsack (--value): a row of value_knapsack_problems_N.csv holds
+// n weights, n values and the capacity.
+struct ValueProblem {
+    std::vector<long long> weights;
+    std::vector<long long> values;
+    long long capacity;
+    std::vector<int> byRatio;  // items by value per unit of weight, best first
+};
+
+ValueProblem parse_value_problem(const std::vector<long long>& row) {
+    size_t n = (row.size() - 1) / 2;
+    ValueProblem problem = {{row.begin(), row.begin() + n}, {row.begin() + n, row.begin() + 2 * n}, row.back(), {}};
+    problem.byRatio.resize(n);
+    for (size_t i = 0; i < n; i++) problem.byRatio[i] = i;
+    std::sort(problem.byRatio.begin(), problem.byRatio.end(), [&](int a, int b) {
+        return static_cast<long double>(problem.values[a]) * problem.weights[b] >
+               static_cast<long double>(problem.values[b]) * problem.weights[a];
+    });
+    return problem;
+}
+
+// Makes an individual feasible: drops the worst-ratio selected items until it fits,
+// then greedily adds the best-ratio items that still fit. Returns its total value.
+long long repair(std::vector<int>& individual, const ValueProblem& problem) {
+    long long weight = 0, value = 0;
+    for (size_t i = 0; i < individual.size(); i++) {
+        if (individual[i]) {
+            weight += problem.weights[i];
+            value += problem.values[i];
+        }
+    }
+    for (auto it = problem.byRatio.rbegin(); it != problem.byRatio.rend() && weight > problem.capacity; ++it) {
+        if (individual[*it]) {
+            individual[*it] = 0;
+            weight -= problem.weights[*it];
+            value -= problem.values[*it];
+        }
+    }
+    for (int i : problem.byRatio) {
+        if (!individual[i] && problem.values[i] > 0 && weight + problem.weights[i] <= problem.capacity) {
+            individual[i] = 1;
+            weight += problem.weights[i];
+            value += problem.values[i];
+        }
+    }
+    return value;
+}
+
+// GA for the value knapsack, meant for capacities too large for the DP in all_sol.cpp.
+// Every child is repaired, so the population stays feasible; fitness is the gap to the
+// sum of all positive values, so the usual minimizing selection applies. Stop rules
+// match genetic_algorithm. bestFitness of the result holds the best value found.
+Result genetic_algorithm_value(const ValueProblem& problem, int pop_size = 10000, int max_generations = 1000,
+                               double mutation_rate = 0.03) {
+    int n = problem.weights.size();
+    long long value_total = 0;
+    for (long long v : problem.values) value_total += std::max(0LL, v);
+
+    std::vector<std::vector<int>> population = create_population(pop_size, n);
+    long long best_value = -1;
+    int no_improvement_count = 0;
+    int generation = 0;
+    auto start_time = std::chrono::high_resolution_clock::now();
+
+    for (; generation < max_generations; generation++) {
+        std::vector<long long> gaps(population.size());
+        for (size_t i = 0; i < population.size(); i++) {
+            gaps[i] = value_total - repair(population[i], problem);
+        }
+
+        long long current_best = value_total - *std::min_element(gaps.begin(), gaps.end());
+        if (current_best > best_value) {
+            best_value = current_best;
+            no_improvement_count = 0;
+        } else {
+            no_improvement_count++;
+        }
+
+        if (best_value == value_total || no_improvement_count >= 2) break;
+        double time_elapsed = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+        if (time_elapsed > 2 * BRUTE_FORCE_TIME) break;
+
+        auto selected = tournament_selection(population, gaps, pop_size);
+        std::vector<std::vector<int>> next_population;
+        for (size_t i = 0; i < selected.size() - 1; i += 2) {
+            auto [child1, child2] = crossover(selected[i], selected[i + 1]);
+            next_population.push_back(mutate(child1, mutation_rate));
+            next_population.push_back(mutate(child2, mutation_rate));
+        }
+        population = next_population;
+    }
+
+    double time_taken = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start_time).count();
+    return {0, time_taken, best_value, no_improvement_count >= 2 || time_taken > 2 * BRUTE_FORCE_TIME, generation};
+}
+
+void process_value_file(int file_num) {
+    std::string input_file = "value_knapsack_problems_" + std::to_string(file_num) + ".csv";
+    std::string output_file = "genetic_value_knapsack_solutions_" + std::to_string(file_num) + ".csv";
+    if (!std::ifstream(input_file).good()) return;
+
+    auto rows = load_problems(input_file);
+    std::ofstream out(output_file);
+    out << "Problem Number,Time Taken (s),Best Value,Stopped By Condition,Last Generation\n";
+    double sum_value = 0;
+    for (size_t i = 0; i < rows.size(); i++) {
+        Result r = genetic_algorithm_value(parse_value_problem(rows[i]));
+        r.problemNumber = i + 1;
+        sum_value += r.bestFitness;
+        out << r.problemNumber << "," << r.timeTaken << "," << r.bestFitness << ","
+            << (r.stoppedByCondition ? "true" : "false") << "," << r.lastGeneration << "\n";
+        std::cout << "Problem " << i + 1 << "/" << rows.size() << " solved: Best Value = " << r.bestFitness
+                  << ", Time = " << std::fixed << std::setprecision(2) << r.timeTaken << "s\n";
+    }
+    std::cout << "\nResults for " << input_file << " saved to " << output_file << "\n";
+    std::cout << "Average best value: " << sum_value / rows.size() << "\n";
+}
+
+// Widest value the solvers of a file have to hold: for each row the total of the
+// absolute weights plus the absolute target. Subset sums stay within the total, and
+// every difference the engines form from target and partial sums (fitness
+// |target - sum|, the exact sweep's target - left and its distance to a right sum)
+// stays within the bound.
+__int128 max_magnitude(const std::vector<std::vector<long long>>& problems) {
+    __int128 magnitude = 0;
+    for (const auto& problem : problems) {
+        __int128 total = 0;
+        for (size_t i = 0; i + 1 < problem.size(); i++) total += problem[i] < 0 ? -__int128(problem[i]) : problem[i];
+        __int128 target = problem.back() < 0 ? -__int128(problem.back()) : problem.back();
+        magnitude = std::max(magnitude, total + target);
+    }
+    return magnitude;
+}
+
+// Online mean and sample variance (Welford), so summaries need no second pass over rows.
+struct RunningStats {
+    uint64_t count = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void add(double x) {
+        count++;
+        double delta = x - mean;
+        mean += delta / count;
+        m2 += delta * (x - mean);
+    }
+
+    double variance() const { return count > 1 ? m2 / (count - 1) : 0.0; }
+    double stddev() const { return std::sqrt(variance()); }
+};
+
+// Log-bucketed time histogram in the spirit of HDR: TIME_SUB_BUCKETS buckets per power
+// of two give quantiles within ~1.6% from nanoseconds to hours in fixed memory.
+const int TIME_MIN_EXPONENT = -30;
+const int TIME_MAX_EXPONENT = 13;
+const int TIME_SUB_BUCKETS = 32;
+
+struct TimeHistogram {
+    std::array<uint64_t, (TIME_MAX_EXPONENT - TIME_MIN_EXPONENT) * TIME_SUB_BUCKETS> buckets{};
+    uint64_t zeros = 0;
+
+    void add(double seconds) {
+        if (seconds <= 0) {
+            zeros++;
+            return;
+        }
+        int exponent;
+        double mantissa = std::frexp(seconds, &exponent);
+        exponent = std::min(std::max(exponent, TIME_MIN_EXPONENT), TIME_MAX_EXPONENT - 1);
+        int sub = std::min(TIME_SUB_BUCKETS - 1, static_cast<int>((mantissa - 0.5) * 2 * TIME_SUB_BUCKETS));
+        buckets[(exponent - TIME_MIN_EXPONENT) * TIME_SUB_BUCKETS + std::max(0, sub)]++;
+    }
+
+    double quantile(double q) const {
+        uint64_t total = zeros;
+        for (uint64_t b : buckets) total += b;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(q * total));
+        uint64_t seen = zeros;
+        if (total == 0 || seen >= rank) return 0.0;
+        for (size_t i = 0; i < buckets.size(); i++) {
+            seen += buckets[i];
+            if (seen >= rank) {
+                int exponent = static_cast<int>(i / TIME_SUB_BUCKETS) + TIME_MIN_EXPONENT;
+                return std::ldexp(0.5 + (i % TIME_SUB_BUCKETS + 0.5) / (2.0 * TIME_SUB_BUCKETS), exponent);
+            }
+        }
+        return 0.0;
+    }
+};
+
+// Per-file aggregates of Time Taken and the exact-solution ratio, kept while solving.
+struct FileSummary {
+    std::string inputFile;
+    long long aMax = 0;
+    RunningStats time;
+    TimeHistogram timeHistogram;
+    uint64_t exact = 0;
+
+    void add(const Result& r) {
+        time.add(r.timeTaken);
+        timeHistogram.add(r.timeTaken);
+        if (r.bestFitness == 0) exact++;
+    }
+};
+
+void print_summary(const std::vector<FileSummary>& summaries) {
+    std::cout << "\nTime Taken summary:\n";
+    std::cout << std::string(118, '-') << "\n";
+    std::cout << std::left << std::setw(26) << "File" << std::setw(12) << "A_MAX" << std::setw(10) << "Problems"
+              << std::setw(10) << "Exact" << std::setw(12) << "Mean" << std::setw(12) << "Variance"
+              << std::setw(12) << "Std Dev" << std::setw(12) << "p50" << std::setw(12) << "p90"
+              << std::setw(12) << "p99" << "\n";
+    std::cout << std::string(118, '-') << "\n";
+    std::cout << std::defaultfloat << std::setprecision(6);
+    for (const auto& s : summaries) {
+        std::cout << std::left << std::setw(26) << s.inputFile << std::setw(12) << s.aMax
+                  << std::setw(10) << s.time.count << std::setw(10) << double(s.exact) / std::max<uint64_t>(1, s.time.count)
+                  << std::setw(12) << s.time.mean << std::setw(12) << s.time.variance() << std::setw(12) << s.time.stddev()
+                  << std::setw(12) << s.timeHistogram.quantile(0.5) << std::setw(12) << s.timeHistogram.quantile(0.9)
+                  << std::setw(12) << s.timeHistogram.quantile(0.99) << "\n";
+    }
+    std::cout << std::string(118, '-') << "\n";
+}
+
+template <typename Weight>
+FileSummary process_problems(const std::string& input_file, const std::string& output_file,
+                      const std::vector<std::vector<long long>>& raw_problems, Checkpoint& checkpoint,
+                      const Options& options) {
+    std::vector<std::vector<Weight>> problems;
+    for (const auto& raw : raw_problems) {
+        problems.emplace_back(raw.begin(), raw.end());
+    }
+    checkpoint.problemCount = problems.size();
     std::vector<Result> results;
     int perfect_solved = 0;
     double sum_fitness = 0;
+    FileSummary summary;
+    summary.inputFile = input_file;
 
-    for (size_t i = 0; i < problems.size(); i++) {
-        int target_weight = problems[i].back();
-        Result result = genetic_algorithm(problems[i], target_weight);
+    if (options.resume && load_checkpoint(checkpoint)) {
+        std::cout << "Resuming " << input_file << " from problem " << checkpoint.results.size() + 1 << "\n";
+        for (const auto& r : checkpoint.results) {
+            results.push_back(r);
+            summary.add(r);
+            if (r.bestFitness == 0) perfect_solved++;
+            sum_fitness += r.bestFitness;
+        }
+    }
+
+    FitnessCache<Weight> cache;
+    GenomeArchive<Weight> archive;
+    std::vector<Result> pending;
+    for (size_t i = results.size(); i < problems.size(); i++) {
+        Result result;
+        if (options.batch && problems[i].size() <= 65) {
+            if (pending.empty()) {
+                size_t end = i;
+                while (end < problems.size() && end - i < BATCH_SIZE && problems[end].size() == problems[i].size()) end++;
+                pending = genetic_algorithm_batch<Weight>({problems.begin() + i, problems.begin() + end});
+                std::reverse(pending.begin(), pending.end());
+                checkpoint.state = GAState();
+            }
+            result = pending.back();
+            pending.pop_back();
+        } else {
+            Weight target_weight = problems[i].back();
+            bool new_weights = i == 0 || problems[i].size() != problems[i - 1].size() ||
+                               !std::equal(problems[i].begin(), problems[i].end() - 1, problems[i - 1].begin());
+            if (new_weights && options.useCache) cache.clear();
+            if (new_weights && options.warmStart) archive.reset({problems[i].begin(), problems[i].end() - 1});
+            if (options.portfolio) {
+                result = race_portfolio(problems[i], target_weight, &checkpoint, options,
+                                        options.useCache ? &cache : nullptr, options.warmStart ? &archive : nullptr);
+            } else if (options.steadyState) {
+                result = genetic_algorithm_steady_state(problems[i], target_weight);
+            } else {
+                result = genetic_algorithm(problems[i], target_weight, &checkpoint, options.adaptive,
+                                           options.useCache ? &cache : nullptr, options.warmStart ? &archive : nullptr,
+                                           options.heuristicSeed);
+            }
+        }
         result.problemNumber = i + 1;
 
         results.push_back(result);
+        summary.add(result);
+        checkpoint.results = results;
+        maybe_save_checkpoint(checkpoint);
         if (result.bestFitness == 0) perfect_solved++;
         sum_fitness += result.bestFitness;
 
         std::cout << "Problem " << i + 1 << "/" << problems.size()
                   << " solved: Best Fitness = " << result.bestFitness
-                  << ", Time = " << std::fixed << std::setprecision(2) << result.timeTaken << "s\n";
+                  << ", Time = " << std::fixed << std::setprecision(2) << result.timeTaken << "s";
+        if (options.useCache && !options.batch && !options.steadyState) std::cout << ", Cache hit rate = " << cache.hit_rate() * 100 << "%";
+        if (result.provedByExact) std::cout << ", proved by exact";
+        std::cout << "\n";
     }
 
-    std::ofstream out(output_file);
-    out << "Problem Number,Time Taken (s),Best Fitness,Stopped By Condition,Last Generation\n";
-    for (const auto& r : results) {
-        out << r.problemNumber << "," << r.timeTaken << "," << r.bestFitness << ","
-            << (r.stoppedByCondition ? "true" : "false") << "," << r.lastGeneration << "\n";
+    if (!options.summaryOnly) {
+        std::ofstream out(output_file);
+        out << "Problem Number,Time Taken (s),Best Fitness,Stopped By Condition,Last Generation"
+            << (options.portfolio ? ",Proved By Exact" : "") << "\n";
+        for (const auto& r : results) {
+            out << r.problemNumber << "," << r.timeTaken << "," << r.bestFitness << ","
+                << (r.stoppedByCondition ? "true" : "false") << "," << r.lastGeneration;
+            if (options.portfolio) out << "," << (r.provedByExact ? "true" : "false");
+            out << "\n";
+        }
     }
-    out.close();
+    std::remove(checkpoint.filename.c_str());
 
     double percentage_solved = (static_cast<double>(perfect_solved) / problems.size()) * 100;
 
@@ -220,12 +1445,130 @@ void process_file(int file_num) {
     std::cout << "Exactly solved problems: " << perfect_solved << "\n";
     std::cout << "Percentage solved: " << percentage_solved << "%\n";
     std::cout << "Average best fitness: " << sum_fitness / problems.size() << "\n";
+    return summary;
 }
 
-int main() {
+// Numbers of the files whose results this run has written. It is cleared at the start
+// of a run without --resume, so resuming skips only files finished by this run and
+// never stale CSVs left over from an earlier one.
+const std::string RUN_MANIFEST = "genetic_knapsack_solutions.run";
+
+std::set<int> load_run_manifest() {
+    std::set<int> completed;
+    std::ifstream file(RUN_MANIFEST);
+    int file_num;
+    while (file >> file_num) completed.insert(file_num);
+    return completed;
+}
+
+void mark_file_completed(int file_num) {
+    std::ofstream file(RUN_MANIFEST, std::ios::app);
+    file << file_num << "\n";
+}
+
+// Picks the narrowest weight type that cannot overflow for this file: 32-bit sums
+// keep the batched engine at 8 lanes per AVX2 register, 64-bit covers the 2^30
+// weights of file 1, and __int128 is left for anything larger.
+FileSummary process_file(int file_num, const Options& options, const std::set<int>& completed) {
+    std::string input_file = "knapsack_problems_" + std::to_string(file_num) + ".csv";
+    std::string output_file = "genetic_knapsack_solutions_" + std::to_string(file_num) + ".csv";
+
+    Checkpoint checkpoint;
+    checkpoint.filename = "genetic_knapsack_solutions_" + std::to_string(file_num) + ".ckpt";
+    if (options.resume && completed.count(file_num) && !std::ifstream(checkpoint.filename).good()) {
+        std::cout << "Skipping " << input_file << ": results already saved\n";
+        return {};
+    }
+
+    auto problems = load_problems(input_file);
+    __int128 magnitude = max_magnitude(problems);
+    FileSummary summary;
+    if (magnitude <= INT32_MAX) {
+        std::cout << "Using 32-bit weights for " << input_file << "\n";
+        summary = process_problems<int32_t>(input_file, output_file, problems, checkpoint, options);
+    } else if (magnitude <= INT64_MAX) {
+        std::cout << "Using 64-bit weights for " << input_file << "\n";
+        summary = process_problems<int64_t>(input_file, output_file, problems, checkpoint, options);
+    } else {
+        std::cout << "Using 128-bit weights for " << input_file << "\n";
+        summary = process_problems<__int128>(input_file, output_file, problems, checkpoint, options);
+    }
+    if (!options.summaryOnly) mark_file_completed(file_num);
+    // Files 1-4 were generated with A_MAX = 2^(24 / d) for densities d = 0.8, 1.0, 1.2, 1.4.
+    const double densities[] = {0.8, 1.0, 1.2, 1.4};
+    summary.aMax = static_cast<long long>(std::pow(2, 24 / densities[(file_num - 1) % 4]));
+    return summary;
+}
+
+// C interface for Python (knapsack.py via ctypes) when built as a shared library:
+//   g++ -std=c++17 -O2 -shared -fPIC -pthread gen_all.cpp -o libgenetic.so
+// Runs genetic_algorithm with 64-bit weights on each row of a contiguous count x n
+// weight matrix and its target, writing into caller-owned arrays, so NumPy buffers
+// cross without copies; ctypes drops the GIL for the duration of the call.
+extern "C" void genetic_solve(const int64_t* weights, const int64_t* targets, int64_t count, int32_t n,
+                              int32_t threads, double* times, int64_t* best_fitness, int32_t* generations) {
+    std::atomic<int64_t> next{0};
+    auto run = [&] {
+        std::vector<int64_t> problem(n + 1);
+        for (int64_t i = next++; i < count; i = next++) {
+            std::copy(weights + i * n, weights + (i + 1) * n, problem.begin());
+            problem[n] = targets[i];
+            Result r = genetic_algorithm<int64_t>(problem, targets[i]);
+            times[i] = r.timeTaken;
+            best_fitness[i] = r.bestFitness;
+            generations[i] = r.lastGeneration;
+        }
+    };
+
+    unsigned int num_threads = threads > 0 ? threads : std::thread::hardware_concurrency();
+    std::vector<std::thread> pool;
+    for (unsigned int t = 1; t < std::max(1u, num_threads); t++) pool.emplace_back(run);
+    run();
+    for (auto& t : pool) t.join();
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int a = 1; a < argc; a++) {
+        std::string arg = argv[a];
+        if (arg == "--resume") options.resume = true;
+        else if (arg == "--adaptive") options.adaptive = true;
+        else if (arg == "--fitness-cache") options.useCache = true;
+        else if (arg == "--batch") options.batch = true;
+        else if (arg == "--warm-start") options.warmStart = true;
+        else if (arg == "--heuristic-seed") options.heuristicSeed = true;
+        else if (arg == "--steady-state") options.steadyState = true;
+        else if (arg == "--portfolio") options.portfolio = true;
+        else if (arg == "--value") options.value = true;
+        else if (arg == "--summary-only") options.summaryOnly = true;
+    }
+
+    // --batch runs its own plain GA over several problems at once and has no room for
+    // the per-problem variants, so combining them is an error rather than silently ignored.
+    const std::pair<bool, const char*> batch_conflicts[] = {
+        {options.steadyState, "--steady-state"}, {options.adaptive, "--adaptive"},
+        {options.useCache, "--fitness-cache"},   {options.warmStart, "--warm-start"},
+        {options.heuristicSeed, "--heuristic-seed"}, {options.portfolio, "--portfolio"},
+    };
+    for (const auto& [set, flag] : batch_conflicts) {
+        if (options.batch && set) {
+            std::cerr << "--batch cannot be combined with " << flag << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<FileSummary> summaries;
+    if (!options.resume) std::ofstream(RUN_MANIFEST, std::ios::trunc);
+    std::set<int> completed = load_run_manifest();
     for (int i = 1; i <= 4; i++) {
-        process_file(i);
+        if (options.value) {
+            process_value_file(i);
+        } else {
+            FileSummary summary = process_file(i, options, completed);
+            if (summary.time.count > 0) summaries.push_back(summary);
+        }
         std::cout << "\n\n";
     }
+    if (!summaries.empty()) print_summary(summaries);
     return 0;
 }
\ No newline at end of file
@@ -6,44 +6,46 @@
 #include <chrono>
 #include <algorithm>
 #include <iomanip>
+#include <climits>
+#include <cstdlib>
 
 const double BRUTE_FORCE_TIME = 15.0;
 
 struct Result {
     int problemNumber;
     double timeTaken;
-    int bestFitness;
+    long long bestFitness;
     bool stoppedByCondition;
     int lastGeneration;
 };
 
-std::vector<std::vector<int>> load_problems(const std::string& filename) {
-    std::vector<std::vector<int>> problems;
+std::vector<std::vector<long long>> load_problems(const std::string& filename) {
+    std::vector<std::vector<long long>> problems;
     std::ifstream file(filename);
     std::string line;
     
     while (std::getline(file, line)) {
-        std::vector<int> problem;
+        std::vector<long long> problem;
         size_t pos = 0;
         std::string token;
         while ((pos = line.find(',')) != std::string::npos) {
             token = line.substr(0, pos);
-            problem.push_back(std::stoi(token));
+            problem.push_back(std::stoll(token));
             line.erase(0, pos + 1);
         }
-        problem.push_back(std::stoi(line));
+        problem.push_back(std::stoll(line));
         problems.push_back(problem);
     }
     file.close();
     return problems;
 }
 
-int fitness(const std::vector<int>& individual, const std::vector<int>& weights, int target_weight) {
-    int total_weight = 0;
+long long fitness(const std::vector<int>& individual, const std::vector<long long>& weights, long long target_weight) {
+    long long total_weight = 0;
     for (size_t i = 0; i < individual.size(); i++) {
         if (individual[i] == 1) total_weight += weights[i];
     }
-    return std::abs(target_weight - total_weight);
+    return std::llabs(target_weight - total_weight);
 }
 
 std::vector<int> create_individual(int n) {
@@ -67,7 +69,7 @@ std::vector<std::vector<int>> create_population(int pop_size, int n) {
 }
 
 std::vector<std::vector<int>> tournament_selection(const std::vector<std::vector<int>>& population, 
-                                                 const std::vector<int>& fitnesses, 
+                                                 const std::vector<long long>& fitnesses, 
                                                  int tournament_size = 3) {
     std::random_device rd;
     std::mt19937 gen(rd());
@@ -113,13 +115,13 @@ std::vector<int> mutate(std::vector<int> individual, double mutation_rate = 0.01
     return individual;
 }
 
-Result genetic_algorithm(const std::vector<int>& problem, int target_weight, 
+Result genetic_algorithm(const std::vector<long long>& problem, long long target_weight, 
                         int pop_size = 10000, int max_generations = 1000, 
                         double mutation_rate = 0.03) {
-    std::vector<int> weights(problem.begin(), problem.end() - 1);
+    std::vector<long long> weights(problem.begin(), problem.end() - 1);
     int n = weights.size();
     auto population = create_population(pop_size, n);
-    int best_fitness = INT_MAX;
+    long long best_fitness = LLONG_MAX;
     int no_improvement_count = 0;
     
     auto start_time = std::chrono::high_resolution_clock::now();
@@ -127,12 +129,12 @@ Result genetic_algorithm(const std::vector<int>& problem, int target_weight,
 
     int generation = 0;
     for (; generation < max_generations; generation++) {
-        std::vector<int> fitnesses(pop_size);
+        std::vector<long long> fitnesses(pop_size);
         for (int i = 0; i < pop_size; i++) {
             fitnesses[i] = fitness(population[i], weights, target_weight);
         }
         
-        int current_best = *std::min_element(fitnesses.begin(), fitnesses.end());
+        long long current_best = *std::min_element(fitnesses.begin(), fitnesses.end());
         if (current_best < best_fitness) {
             best_fitness = current_best;
             no_improvement_count = 0;
@@ -177,7 +179,7 @@ void process_file(int file_num) {
     double sum_fitness = 0;
 
     for (size_t i = 0; i < problems.size(); i++) {
-        int target_weight = problems[i].back();
+        long long target_weight = problems[i].back();
         Result result = genetic_algorithm(problems[i], target_weight);
         result.problemNumber = i + 1;
         
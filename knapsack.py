@@ -0,0 +1,67 @@
+import ctypes
+import os
+import numpy as np
+
+# Привязки к решателям на C++ через ctypes. Библиотеки собираются так:
+#   g++ -std=c++17 -O2 -shared -fPIC -pthread all_sol.cpp -o libknapsack.so
+#   g++ -std=c++17 -O2 -shared -fPIC -pthread gen_all.cpp -o libgenetic.so
+# Веса — матрица (задачи x n), цели — вектор. Массивы int64 в порядке C передаются
+# без копирования, результаты пишутся прямо в новые массивы NumPy. На время решения
+# ctypes отпускает GIL, так что вызовы из разных потоков Python идут параллельно.
+
+_dir = os.path.dirname(os.path.abspath(__file__))
+_int64_matrix = np.ctypeslib.ndpointer(dtype=np.int64, ndim=2, flags="C_CONTIGUOUS")
+_int64_vector = np.ctypeslib.ndpointer(dtype=np.int64, ndim=1, flags="C_CONTIGUOUS")
+_int32_vector = np.ctypeslib.ndpointer(dtype=np.int32, ndim=1, flags="C_CONTIGUOUS")
+_double_vector = np.ctypeslib.ndpointer(dtype=np.float64, ndim=1, flags="C_CONTIGUOUS")
+
+_solvers = ctypes.CDLL(os.path.join(_dir, "libknapsack.so"))
+_solvers.knapsack_solve.restype = ctypes.c_int
+_solvers.knapsack_solve.argtypes = [ctypes.c_char_p, _int64_matrix, _int64_vector, ctypes.c_int64, ctypes.c_int32,
+                                    ctypes.c_int64, ctypes.c_int32, _double_vector, _double_vector, _int32_vector]
+
+_genetic = ctypes.CDLL(os.path.join(_dir, "libgenetic.so"))
+_genetic.genetic_solve.restype = None
+_genetic.genetic_solve.argtypes = [_int64_matrix, _int64_vector, ctypes.c_int64, ctypes.c_int32, ctypes.c_int32,
+                                   _double_vector, _int64_vector, _int32_vector]
+
+
+def _prepare(weights, targets):
+    # Копия делается только если массив не int64 или не непрерывный.
+    weights = np.ascontiguousarray(weights, dtype=np.int64)
+    targets = np.ascontiguousarray(targets, dtype=np.int64)
+    if weights.ndim != 2 or targets.shape != (weights.shape[0],):
+        raise ValueError("ожидаются веса формы (задачи, n) и цели формы (задачи,)")
+    return weights, targets
+
+def solve(weights, targets, engine="auto", modulus=0, threads=0):
+    """Точные методы all_sol.cpp (bruteforce, blocked, bnb, ss, lll, bitset, approx, modular, auto).
+    Методу modular нужен modulus > 0.
+    Возвращает время первого решения, время всех решений и число решений по задачам."""
+    weights, targets = _prepare(weights, targets)
+    count, n = weights.shape
+    if engine == "modular" and modulus <= 0:
+        raise ValueError("методу modular нужен modulus > 0")
+    if n < 1:
+        raise ValueError("у задач должен быть хотя бы один вес")
+    first_times = np.zeros(count)
+    all_times = np.zeros(count)
+    counts = np.zeros(count, dtype=np.int32)
+    if _solvers.knapsack_solve(engine.encode(), weights, targets, count, n, modulus, threads,
+                               first_times, all_times, counts) != 0:
+        raise ValueError(f"неизвестный метод или некорректные аргументы: {engine}")
+    return first_times, all_times, counts
+
+def solve_modular(weights, targets, modulus, threads=0):
+    """Число подмножеств с суммой, равной цели по модулю modulus."""
+    return solve(weights, targets, engine="modular", modulus=modulus, threads=threads)
+
+def genetic(weights, targets, threads=0):
+    """genetic_algorithm из gen_all.cpp: время, лучшая приспособленность и последнее поколение."""
+    weights, targets = _prepare(weights, targets)
+    count, n = weights.shape
+    times = np.zeros(count)
+    best_fitness = np.zeros(count, dtype=np.int64)
+    generations = np.zeros(count, dtype=np.int32)
+    _genetic.genetic_solve(weights, targets, count, n, threads, times, best_fitness, generations)
+    return times, best_fitness, generations
@@ -0,0 +1,24 @@
+import random
+import csv
+
+# Максимальные веса для файлов 1-4: вместимости первых трёх укладываются в динамику
+# all_sol.cpp, у четвёртого веса большие и задачи решаются перебором или GA.
+MAX_WEIGHTS = [2**10, 2**14, 2**16, 2**30]
+
+
+def generate_value_problems(count=50, length=24, max_weight=2**16, max_value=1000, min_ratio=0.2, max_ratio=0.6):
+    for _ in range(count):
+        weights = [random.randint(1, max_weight) for _ in range(length)]
+        values = [random.randint(1, max_value) for _ in range(length)]
+        capacity = int(sum(weights) * random.uniform(min_ratio, max_ratio))
+        yield [*weights, *values, capacity]
+
+def save_to_csv(filename, data):
+    with open(filename, "w", newline="") as f:
+        writer = csv.writer(f)
+        writer.writerows(data)
+
+for i, max_weight in enumerate(MAX_WEIGHTS, start=1):
+    save_to_csv(f"value_knapsack_problems_{i}.csv", generate_value_problems(max_weight=max_weight))
+
+print("Задачи о рюкзаке с ценностями сохранены в value_knapsack_problems_1..4.csv.")
@@ -0,0 +1,55 @@
+import socket
+import struct
+import sys
+import time
+import csv
+
+# Клиент демона all_sol (--daemon=ПУТЬ). Кадр: длина (uint32) и тело.
+# Запрос: магия KSRQ, число задач, n, режим, имя метода (16 байт), затем веса и цели (int64).
+# Ответ: по кадру на задачу (номер, время первого решения, время всех, число решений),
+# кадр с номером -1 завершает пакет, кадр с номером -2 сообщает о некорректном запросе.
+REQUEST_HEADER = struct.Struct("<4sIIB16s")
+RESPONSE = struct.Struct("<iddi")
+MODES = {"count": 0, "exists": 1, "best": 2}
+
+
+def read_exact(sock, size):
+    data = b""
+    while len(data) < size:
+        chunk = sock.recv(size - len(data))
+        if not chunk:
+            raise ConnectionError("демон закрыл соединение")
+        data += chunk
+    return data
+
+def solve(sock, problems, engine="auto", mode="count"):
+    n = len(problems[0]) - 1
+    body = REQUEST_HEADER.pack(b"KSRQ", len(problems), n, MODES[mode], engine.encode())
+    body += struct.pack(f"<{len(problems) * (n + 1)}q", *(x for problem in problems for x in problem))
+    sock.sendall(struct.pack("<I", len(body)) + body)
+
+    results = [None] * len(problems)
+    while True:
+        size, = struct.unpack("<I", read_exact(sock, 4))
+        index, first_time, all_time, count = RESPONSE.unpack(read_exact(sock, size))
+        if index == -2:
+            raise ValueError("демон отклонил запрос")
+        if index < 0:
+            return results
+        results[index] = (first_time, all_time, count)
+
+if __name__ == "__main__":
+    socket_path, problems_file = sys.argv[1], sys.argv[2]
+    engine = sys.argv[3] if len(sys.argv) > 3 else "auto"
+    with open(problems_file) as f:
+        problems = [list(map(int, row)) for row in csv.reader(f)]
+
+    with socket.socket(socket.AF_UNIX, socket.SOCK_STREAM) as sock:
+        sock.connect(socket_path)
+        start = time.perf_counter()
+        results = solve(sock, problems, engine)
+        elapsed = time.perf_counter() - start
+
+    for i, (first_time, all_time, count) in enumerate(results, start=1):
+        print(f"Задача {i}: решений {count}, время {all_time:.6f} с")
+    print(f"Пакет из {len(problems)} задач обработан за {elapsed * 1e6:.0f} мкс")